@@ -0,0 +1,10 @@
+# Adds the target 'protobuf_footprint' (west build -t protobuf_footprint), which reports the ROM
+# and RAM that every protobuf message type adds to the application.
+function(add_protobuf_footprint_target)
+  add_custom_target(
+    protobuf_footprint
+    COMMAND ${PYTHON_EXECUTABLE} ${CMAKE_CURRENT_FUNCTION_LIST_DIR}/protobuf_footprint.py
+            --nm ${CMAKE_NM} ${ZEPHYR_BINARY_DIR}/${KERNEL_ELF_NAME}
+    DEPENDS ${logical_target_for_zephyr_elf}
+    USES_TERMINAL)
+endfunction()
@@ -0,0 +1,106 @@
+'''protobuf_footprint.py
+
+Reports the ROM and RAM that every protobuf message type adds to an ELF file.
+
+The symbols are read with nm and assigned to a message type, if they belong to an instantiation
+for the type (protobuf::message, protobuf::codec, the protobuf read/write of the storage) or to
+the descriptor that nanopb generates for it (<type>_msg, <type>_field_info, ...). Everything of
+nanopb itself and of the non-template core is reported as shared.'''
+
+import argparse
+import re
+import subprocess
+import sys
+from collections import defaultdict
+
+# symbol types of nm that end up in ROM or RAM
+ROM_TYPES = set('TtRrWwVv')
+RAM_TYPES = set('DdBbGgSs')
+
+# instantiations for a message type, with the type as first template argument
+TEMPLATE_PATTERNS = [
+    re.compile(r'protobuf::message<(\w+),'),
+    re.compile(r'protobuf::codec<(\w+)>'),
+    re.compile(r'protobuf::scalar_codec<(\w+)[,>]'),
+    re.compile(r'protobuf::detail::scalar_field<&(\w+)::'),
+    re.compile(r'::(?:read|write)<(\w+), \d+u?l?>'),
+]
+
+# nanopb library and the type-independent core of protobuf::message
+SHARED_PATTERNS = [
+    re.compile(r'^pb_'),
+    re.compile(r'^protobuf::detail::(?:encode|decode|log_codec_failure)\('),
+    re.compile(r'^protobuf::arena'),
+    re.compile(r'^protobuf::string_field'),
+]
+
+
+def read_symbols(nm, elf):
+    '''Returns (size, type, demangled name) of all symbols with a size.'''
+    output = subprocess.run([nm, '--print-size', '--size-sort', '--demangle', elf],
+                            check=True, capture_output=True, text=True).stdout
+    for line in output.splitlines():
+        parts = line.split(maxsplit=3)
+        if len(parts) == 4:
+            yield int(parts[1], 16), parts[2], parts[3]
+
+
+def message_type_of(name, descriptor_prefixes):
+    for pattern in TEMPLATE_PATTERNS:
+        match = pattern.search(name)
+        if match:
+            # nanopb names the structs _<type> and defines <type> as typedef
+            return match.group(1).removeprefix('_')
+
+    # generated descriptors: RuntimeStatistics_msg, RuntimeStatistics_field_info, ...
+    match = descriptor_prefixes.match(name)
+    if match:
+        return match.group(1)
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[1])
+    parser.add_argument('--nm', default='nm', help='nm of the toolchain')
+    parser.add_argument('elf', help='ELF file of the application')
+    args = parser.parse_args()
+
+    symbols = list(read_symbols(args.nm, args.elf))
+
+    # the message types are known from the descriptors that nanopb generates
+    types = sorted({name[:-len('_msg')] for _, _, name in symbols if name.endswith('_msg')})
+    if not types:
+        print('No protobuf message descriptors found.', file=sys.stderr)
+        return 1
+    descriptor_prefixes = re.compile(r'^(' + '|'.join(map(re.escape, types)) + r')_\w+$')
+
+    rom = defaultdict(int)
+    ram = defaultdict(int)
+    for size, symbol_type, name in symbols:
+        if any(pattern.search(name) for pattern in SHARED_PATTERNS):
+            owner = '(shared)'
+        else:
+            owner = message_type_of(name, descriptor_prefixes)
+            if owner is None:
+                continue
+
+        if symbol_type in ROM_TYPES:
+            rom[owner] += size
+        elif symbol_type in RAM_TYPES:
+            ram[owner] += size
+
+    # instantiations for types without a descriptor in the ELF are listed as well
+    types = sorted(set(types) | (set(rom) | set(ram)) - {'(shared)'})
+
+    print(f'{"message type":<32} {"ROM":>8} {"RAM":>8}')
+    for owner in types + ['(shared)']:
+        print(f'{owner:<32} {rom[owner]:>8} {ram[owner]:>8}')
+
+    per_type = [rom[owner] for owner in types]
+    print(f'{"total":<32} {sum(rom.values()):>8} {sum(ram.values()):>8}')
+    print(f'{"average ROM per message type":<32} {sum(per_type) // len(per_type):>8}')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
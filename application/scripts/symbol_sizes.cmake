@@ -0,0 +1,10 @@
+# Adds a target (west build -t <name>), which reports the size of all symbols of the application
+# whose demangled name matches the regular expression 'filter'.
+function(add_symbol_sizes_target name filter)
+  add_custom_target(
+    ${name}
+    COMMAND ${PYTHON_EXECUTABLE} ${CMAKE_CURRENT_FUNCTION_LIST_DIR}/symbol_sizes.py
+            --nm ${CMAKE_NM} --filter ${filter} ${ZEPHYR_BINARY_DIR}/${KERNEL_ELF_NAME}
+    DEPENDS ${logical_target_for_zephyr_elf}
+    USES_TERMINAL)
+endfunction()
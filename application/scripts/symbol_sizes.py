@@ -0,0 +1,45 @@
+'''symbol_sizes.py
+
+Reports the size of all symbols of an ELF file whose demangled name matches a regular expression.
+
+Used to track the code size of functions that are benchmarked (e.g. the error paths), so that
+changes to their implementation are judged on their size as well as on their cycles.'''
+
+import argparse
+import re
+import subprocess
+import sys
+
+
+def read_symbols(nm, elf):
+    '''Returns (size, type, demangled name) of all symbols with a size.'''
+    output = subprocess.run([nm, '--print-size', '--size-sort', '--demangle', elf],
+                            check=True, capture_output=True, text=True).stdout
+    for line in output.splitlines():
+        parts = line.split(maxsplit=3)
+        if len(parts) == 4:
+            yield int(parts[1], 16), parts[2], parts[3]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[1])
+    parser.add_argument('--nm', default='nm', help='nm of the toolchain')
+    parser.add_argument('--filter', required=True, help='regular expression for the names')
+    parser.add_argument('elf', help='ELF file of the application')
+    args = parser.parse_args()
+
+    pattern = re.compile(args.filter)
+    symbols = [(size, name) for size, _, name in read_symbols(args.nm, args.elf)
+               if pattern.search(name)]
+    if not symbols:
+        print(f'No symbols match {args.filter}.', file=sys.stderr)
+        return 1
+
+    for size, name in sorted(symbols, key=lambda symbol: symbol[1]):
+        print(f'{size:>8}  {name}')
+    print(f'{sum(size for size, _ in symbols):>8}  total')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
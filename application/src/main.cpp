@@ -1,10 +1,15 @@
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include "os/periodic_task.hpp"
 #include "protobuf/protobuf_message.hpp"
 #include "storage/non_volatile_storage.hpp"
 
-#include "protobuf/storage.pb.h"
+#ifdef CONFIG_APP_STORAGE_SCRUBBER
+#include "storage/scrubber.hpp"
+#endif
+
+#include "protobuf/storage_messages.hpp"
 #include <pb_decode.h>
 #include <pb_encode.h>
 
@@ -19,14 +24,8 @@ LOG_MODULE_REGISTER(example, LOG_LEVEL_DBG);
  */
 static const struct gpio_dt_spec led = GPIO_DT_SPEC_GET(LED0_NODE, gpios);
 
-void handle_boot_counter()
+void handle_boot_counter(non_volatile_storage &storage)
 {
-	non_volatile_storage storage{};
-	const auto init_error = storage.init();
-	if (init_error) {
-		LOG_ERR("Failed to initialize the storage: %s", init_error.message());
-	}
-
 	constexpr uint16_t static_number_id = 2U;
 
 	const auto number = storage.read<uint16_t>(static_number_id);
@@ -60,30 +59,66 @@ void handle_boot_counter()
 	}
 }
 
-void led_blink_loop()
+#ifdef CONFIG_APP_STORAGE_SCRUBBER
+void report_corruption(uint16_t id, util::error_code error)
+{
+	LOG_ERR("Record %u is corrupted: %s", id, error.message());
+}
+#endif
+
+bool configure_led()
 {
 	if (!gpio_is_ready_dt(&led)) {
-		return;
+		return false;
 	}
 
-	int ret = gpio_pin_configure_dt(&led, GPIO_OUTPUT_ACTIVE);
+	return gpio_pin_configure_dt(&led, GPIO_OUTPUT_ACTIVE) >= 0;
+}
+
+void toggle_led(void *context)
+{
+	const int ret = gpio_pin_toggle_dt(&led);
 	if (ret < 0) {
+		static_cast<os::periodic_task *>(context)->stop();
 		return;
 	}
 
-	while (1) {
-		ret = gpio_pin_toggle_dt(&led);
-		if (ret < 0) {
-			return;
-		}
-		os::sleep(1s);
-	}
+	// the boot is completed with the first toggle of the led
+	os::profiling::mark("first led toggle");
+	os::profiling::dump();
 }
 
 int main(void)
 {
+	// the cycle counter starts during kernel init, so this marks the end of the kernel init
+	os::profiling::mark("main");
 	LOG_DBG("Starting main function.");
-	handle_boot_counter();
-	led_blink_loop();
+
+	// the led is toggled on the periodic task thread, starting right away and before the first
+	// storage access, so that blinking does not wait for the mount of the storage
+	if (configure_led()) {
+		static os::periodic_task blink{toggle_led, &blink};
+		blink.start(1s, 0s);
+	}
+
+	// with CONFIG_APP_STORAGE_LAZY_MOUNT the storage gets mounted in the background and only
+	// the boot counter waits for it; shared with the other modules (e.g. the settings backend)
+	auto &storage = shared_storage();
+	const auto init_error = storage.init();
+	if (init_error) {
+		LOG_ERR("Failed to initialize the storage: %s", init_error.message());
+	}
+
+#ifdef CONFIG_APP_STORAGE_SCRUBBER
+	// static, as the stack of the scrubber thread is part of the object
+	static storage::scrubber<storage::default_backend> scrubber{storage, report_corruption};
+	scrubber.start();
+#endif
+
+	{
+		const os::profiling::scoped_timer timer{"handle_boot_counter"};
+		handle_boot_counter(storage);
+	}
+
 	return 0;
 }
@@ -0,0 +1,125 @@
+#include "coroutine.hpp"
+#include <zephyr/logging/log.h>
+#include <array>
+#include <cstddef>
+
+LOG_MODULE_REGISTER(coroutine);
+
+namespace
+{
+constexpr size_t frame_count = CONFIG_APP_COROUTINE_MAX_TASKS;
+constexpr size_t frame_alignment = alignof(std::max_align_t);
+constexpr size_t frame_size = ROUND_UP(CONFIG_APP_COROUTINE_FRAME_SIZE, frame_alignment);
+
+alignas(frame_alignment) std::array<char, frame_size * frame_count> frame_memory;
+struct k_mem_slab frame_slab;
+
+K_THREAD_STACK_DEFINE(coroutine_stack, CONFIG_APP_COROUTINE_THREAD_STACK_SIZE);
+struct k_work_q coroutine_work_queue;
+
+K_THREAD_STACK_DEFINE(offload_stack, CONFIG_APP_COROUTINE_OFFLOAD_THREAD_STACK_SIZE);
+struct k_work_q offload_work_queue;
+
+/// Work items of a frame, which outlive the coroutines that use the frame.
+struct frame_slot {
+	struct k_work_delayable resume_work;
+	struct k_work offload_work;
+	std::coroutine_handle<> handle;
+	void (*offload_function)(void *context);
+	void *offload_context;
+};
+
+std::array<frame_slot, frame_count> slots;
+
+frame_slot &slot_of(const void *frame)
+{
+	// the promise is part of the frame, so every address within the block identifies the slot
+	const auto offset = static_cast<const char *>(frame) - frame_memory.data();
+	return slots[static_cast<size_t>(offset) / frame_size];
+}
+
+void resume_handler(struct k_work *work)
+{
+	auto *const slot = CONTAINER_OF(k_work_delayable_from_work(work), frame_slot, resume_work);
+
+	// the coroutine may end and free its frame, but the slot stays valid
+	slot->handle.resume();
+}
+
+void offload_handler(struct k_work *work)
+{
+	auto *const slot = CONTAINER_OF(work, frame_slot, offload_work);
+
+	slot->offload_function(slot->offload_context);
+	k_work_schedule_for_queue(&coroutine_work_queue, &slot->resume_work, K_NO_WAIT);
+}
+
+int start_coroutine_work_queues()
+{
+	k_mem_slab_init(&frame_slab, frame_memory.data(), frame_size, frame_count);
+	for (auto &slot : slots) {
+		k_work_init_delayable(&slot.resume_work, resume_handler);
+		k_work_init(&slot.offload_work, offload_handler);
+	}
+
+	const struct k_work_queue_config coroutine_config = {
+		.name = "coroutine", .no_yield = false, .essential = false};
+	k_work_queue_init(&coroutine_work_queue);
+	k_work_queue_start(&coroutine_work_queue, coroutine_stack,
+			   K_THREAD_STACK_SIZEOF(coroutine_stack),
+			   CONFIG_APP_COROUTINE_THREAD_PRIORITY, &coroutine_config);
+
+	const struct k_work_queue_config offload_config = {
+		.name = "coroutine_offload", .no_yield = false, .essential = false};
+	k_work_queue_init(&offload_work_queue);
+	k_work_queue_start(&offload_work_queue, offload_stack, K_THREAD_STACK_SIZEOF(offload_stack),
+			   CONFIG_APP_COROUTINE_OFFLOAD_THREAD_PRIORITY, &offload_config);
+	return 0;
+}
+
+SYS_INIT(start_coroutine_work_queues, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+} // namespace
+
+namespace os::detail
+{
+
+void *allocate_frame(size_t size) noexcept
+{
+	if (size > frame_size) {
+		LOG_ERR("Coroutine frame of %zu bytes exceeds %zu bytes", size, frame_size);
+		return nullptr;
+	}
+
+	void *frame = nullptr;
+	if (k_mem_slab_alloc(&frame_slab, &frame, K_NO_WAIT) != 0) {
+		LOG_WRN("%s", "No coroutine frame available.");
+		return nullptr;
+	}
+	return frame;
+}
+
+void free_frame(void *frame) noexcept
+{
+	k_mem_slab_free(&frame_slab, frame);
+}
+
+void bind_frame(const void *frame, std::coroutine_handle<> handle)
+{
+	slot_of(frame).handle = handle;
+}
+
+void resume_frame(const void *frame, k_timeout_t delay)
+{
+	k_work_schedule_for_queue(&coroutine_work_queue, &slot_of(frame).resume_work, delay);
+}
+
+void offload_frame(const void *frame, void (*function)(void *context), void *context)
+{
+	auto &slot = slot_of(frame);
+	slot.offload_function = function;
+	slot.offload_context = context;
+	k_work_submit_to_queue(&offload_work_queue, &slot.offload_work);
+}
+
+} // namespace os::detail
@@ -0,0 +1,219 @@
+#ifndef OS_COROUTINE_HPP
+#define OS_COROUTINE_HPP
+
+#include <zephyr/kernel.h>
+#include "os/kernel.hpp"
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace os
+{
+
+namespace detail
+{
+// The frames of the coroutines are allocated from a static pool with one work item for resuming
+// and one for offloading per frame. The work items are not part of the frames, as the work queue
+// still accesses them after their handler returned, when the frame may already be freed.
+
+/**
+ * @brief Allocates a coroutine frame, or returns nullptr if it is too large or none is left.
+ */
+void *allocate_frame(size_t size) noexcept;
+void free_frame(void *frame) noexcept;
+
+/**
+ * @brief Sets the coroutine that gets resumed by the work items of the frame.
+ */
+void bind_frame(const void *frame, std::coroutine_handle<> handle);
+
+/**
+ * @brief Resumes the coroutine of the frame on the coroutine work queue after the delay.
+ */
+void resume_frame(const void *frame, k_timeout_t delay);
+
+/**
+ * @brief Executes the function on the offload work queue and resumes the coroutine afterwards.
+ */
+void offload_frame(const void *frame, void (*function)(void *context), void *context);
+} // namespace detail
+
+/**
+ * @brief Coroutine that runs on the coroutine work queue until its end (fire and forget).
+ *
+ * The coroutine starts on the work queue and not in the caller. Its frame is allocated from a
+ * static pool (CONFIG_APP_COROUTINE_MAX_TASKS frames of CONFIG_APP_COROUTINE_FRAME_SIZE bytes)
+ * and freed at its end. If no frame is available, the coroutine is not started, which is
+ * indicated by the returned task.
+ *
+ * While a coroutine waits (e.g. for async_sleep or offload), the work queue thread executes the
+ * other coroutines. Completion has to be signaled by the coroutine itself, if somebody waits for
+ * it.
+ */
+class task
+{
+public:
+	struct promise_type {
+		static void *operator new(size_t size) noexcept
+		{
+			return detail::allocate_frame(size);
+		}
+
+		static void operator delete(void *frame) noexcept
+		{
+			detail::free_frame(frame);
+		}
+
+		static task get_return_object_on_allocation_failure() noexcept
+		{
+			return task{false};
+		}
+
+		task get_return_object() noexcept
+		{
+			using handle_type = std::coroutine_handle<promise_type>;
+			detail::bind_frame(this, handle_type::from_promise(*this));
+			return task{true};
+		}
+
+		// the coroutine starts on the work queue
+		auto initial_suspend() noexcept
+		{
+			struct start_on_work_queue {
+				bool await_ready() const noexcept
+				{
+					return false;
+				}
+
+				void
+				await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+				{
+					handle.promise().resume(K_NO_WAIT);
+				}
+
+				void await_resume() const noexcept
+				{
+				}
+			};
+			return start_on_work_queue{};
+		}
+
+		std::suspend_never final_suspend() noexcept
+		{
+			return {};
+		}
+
+		void return_void() noexcept
+		{
+		}
+
+		void unhandled_exception() noexcept
+		{
+			std::terminate();
+		}
+
+		void resume(k_timeout_t delay) noexcept
+		{
+			detail::resume_frame(this, delay);
+		}
+
+		void offload(void (*function)(void *context), void *context) noexcept
+		{
+			detail::offload_frame(this, function, context);
+		}
+	};
+
+	/**
+	 * @brief Whether the coroutine was started (false, if no frame could be allocated).
+	 */
+	explicit operator bool() const
+	{
+		return started;
+	}
+
+private:
+	explicit task(bool started) : started(started)
+	{
+	}
+
+	bool started;
+};
+
+/**
+ * @brief Awaitable that resumes the coroutine after the timeout, without blocking the thread.
+ */
+class async_sleep
+{
+public:
+	explicit async_sleep(std::chrono::milliseconds timeout) : timeout(timeout)
+	{
+	}
+
+	bool await_ready() const noexcept
+	{
+		return timeout.count() <= 0;
+	}
+
+	void await_suspend(std::coroutine_handle<task::promise_type> handle) const noexcept
+	{
+		handle.promise().resume(K_MSEC(timeout.count()));
+	}
+
+	void await_resume() const noexcept
+	{
+	}
+
+private:
+	std::chrono::milliseconds timeout;
+};
+
+/**
+ * @brief Awaitable that executes a blocking function on the offload work queue and resumes the
+ *        coroutine with its result afterwards.
+ *
+ * This keeps the coroutine work queue free for other coroutines, while e.g. the flash is accessed.
+ */
+template <typename function_type>
+class offload
+{
+public:
+	using result_type = std::invoke_result_t<function_type &>;
+	static_assert(!std::is_void_v<result_type>, "the function must return a result");
+
+	explicit offload(function_type function) : function(std::move(function))
+	{
+	}
+
+	bool await_ready() const noexcept
+	{
+		return false;
+	}
+
+	void await_suspend(std::coroutine_handle<task::promise_type> handle) noexcept
+	{
+		handle.promise().offload(execute, this);
+	}
+
+	result_type await_resume()
+	{
+		return std::move(*result);
+	}
+
+private:
+	static void execute(void *context)
+	{
+		auto &self = *static_cast<offload *>(context);
+		self.result.emplace(self.function());
+	}
+
+	function_type function;
+	std::optional<result_type> result{};
+};
+
+} // namespace os
+
+#endif /* OS_COROUTINE_HPP */
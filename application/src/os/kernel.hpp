@@ -1,9 +1,11 @@
 #ifndef OS_KERNEL_HPP
 #define OS_KERNEL_HPP
 
+#include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include "util/system_error.hpp"
 #include <chrono>
+#include <cstdint>
 
 using namespace std::chrono_literals; // make the chrono literals available for all users
 
@@ -30,6 +32,27 @@ inline util::error_code result_to_error_code(int error)
 	return util::errc{-error};
 }
 
+/**
+ * @brief Helper function to convert an error_code to the result of a Zephyr callback.
+ *
+ * Errors without an errno equivalent (e.g. the storage errors) are returned as -EIO.
+ *
+ * @param error The error code to be converted.
+ * @return 0 for no error, otherwise a negative errno value.
+ */
+inline int error_code_to_result(util::error_code error)
+{
+	if (!error) {
+		return 0;
+	}
+
+	const auto condition = error.default_error_condition();
+	if (condition.category() == util::generic_category()) {
+		return -condition.value();
+	}
+	return -EIO;
+}
+
 /**
  * @brief Wrapper around the millisecond sleep function of Zephyr to enable the use of std::chrono.
  */
@@ -38,6 +61,80 @@ inline std::chrono::milliseconds sleep(std::chrono::milliseconds timeout)
 	return std::chrono::milliseconds{k_msleep(timeout.count())};
 }
 
+namespace profiling
+{
+
+#ifdef CONFIG_APP_BOOT_PROFILING
+/**
+ * @brief Records a section of the startup path into the static profiling buffer.
+ *
+ * Sections are ignored once the buffer is full or the profile was already dumped.
+ *
+ * @param label Static string naming the section.
+ * @param start Cycle counter value at the begin of the section.
+ * @param end Cycle counter value at the end of the section.
+ */
+void record(const char *label, uint32_t start, uint32_t end);
+
+/**
+ * @brief Logs all recorded sections and stops the recording.
+ */
+void dump();
+#else
+inline void record(const char *, uint32_t, uint32_t)
+{
+}
+
+inline void dump()
+{
+}
+#endif
+
+/**
+ * @brief Records a point in time (e.g. reaching main) as a section without duration.
+ */
+inline void mark(const char *label)
+{
+#ifdef CONFIG_APP_BOOT_PROFILING
+	const auto now = k_cycle_get_32();
+	record(label, now, now);
+#endif
+}
+
+/**
+ * @brief Records the lifetime of the timer object as a section of the startup profile.
+ *
+ * Compiles to nothing if CONFIG_APP_BOOT_PROFILING is disabled.
+ */
+class scoped_timer
+{
+public:
+	explicit scoped_timer(const char *label)
+#ifdef CONFIG_APP_BOOT_PROFILING
+		: label(label), start(k_cycle_get_32())
+#endif
+	{
+	}
+
+	~scoped_timer()
+	{
+#ifdef CONFIG_APP_BOOT_PROFILING
+		record(label, start, k_cycle_get_32());
+#endif
+	}
+
+	scoped_timer(const scoped_timer &) = delete;
+	scoped_timer &operator=(const scoped_timer &) = delete;
+
+#ifdef CONFIG_APP_BOOT_PROFILING
+private:
+	const char *label;
+	uint32_t start;
+#endif
+};
+
+} // namespace profiling
+
 } // namespace os
 
 #endif /* OS_KERNEL_HPP */
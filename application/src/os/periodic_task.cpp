@@ -0,0 +1,86 @@
+#include "periodic_task.hpp"
+
+namespace
+{
+K_THREAD_STACK_DEFINE(periodic_task_stack, CONFIG_APP_PERIODIC_TASK_THREAD_STACK_SIZE);
+struct k_work_q periodic_task_work_queue;
+
+int start_periodic_task_work_queue()
+{
+	const struct k_work_queue_config config = {
+		.name = "periodic_task", .no_yield = false, .essential = false};
+
+	k_work_queue_init(&periodic_task_work_queue);
+	k_work_queue_start(&periodic_task_work_queue, periodic_task_stack,
+			   K_THREAD_STACK_SIZEOF(periodic_task_stack),
+			   CONFIG_APP_PERIODIC_TASK_THREAD_PRIORITY, &config);
+	return 0;
+}
+
+SYS_INIT(start_periodic_task_work_queue, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+} // namespace
+
+namespace os
+{
+
+periodic_task::periodic_task(task_function function, void *context)
+	: function(function), context(context)
+{
+	execution.task = this;
+	k_work_init(&execution.work, work_handler);
+	k_timer_init(&timer, expiry_handler, nullptr);
+	k_timer_user_data_set(&timer, this);
+}
+
+periodic_task::~periodic_task()
+{
+	// the work queue must not execute the function anymore after the destruction
+	k_timer_stop(&timer);
+	struct k_work_sync sync;
+	k_work_cancel_sync(&execution.work, &sync);
+}
+
+void periodic_task::start(std::chrono::microseconds period, std::chrono::microseconds delay)
+{
+	k_timer_stop(&timer);
+
+	start_ticks = k_uptime_ticks() + k_us_to_ticks_ceil64(delay.count());
+	period_us = period.count();
+	deadline_count = 0U;
+	overrun_count = 0U;
+
+	k_timer_start(&timer, K_TIMEOUT_ABS_TICKS(start_ticks), K_NO_WAIT);
+}
+
+void periodic_task::stop()
+{
+	k_timer_stop(&timer);
+	(void)k_work_cancel(&execution.work);
+}
+
+void periodic_task::expiry_handler(struct k_timer *timer)
+{
+	auto *const task = static_cast<periodic_task *>(k_timer_user_data_get(timer));
+
+	// the next deadline is calculated from the start and not from the current time
+	task->deadline_count++;
+	const int64_t next_deadline =
+		task->start_ticks + k_us_to_ticks_near64(task->deadline_count * task->period_us);
+	k_timer_start(timer, K_TIMEOUT_ABS_TICKS(next_deadline), K_NO_WAIT);
+
+	// 0 means that the previous execution is still waiting to be executed
+	if (k_work_submit_to_queue(&periodic_task_work_queue, &task->execution.work) == 0) {
+		task->overrun_count++;
+	}
+}
+
+void periodic_task::work_handler(struct k_work *work)
+{
+	auto *const job = CONTAINER_OF(work, task_work, work);
+	auto *const task = job->task;
+
+	task->function(task->context);
+}
+
+} // namespace os
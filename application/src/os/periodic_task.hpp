@@ -0,0 +1,90 @@
+#ifndef OS_PERIODIC_TASK_HPP
+#define OS_PERIODIC_TASK_HPP
+
+#include <zephyr/kernel.h>
+#include "os/kernel.hpp"
+#include <chrono>
+#include <cstdint>
+
+namespace os
+{
+
+/**
+ * @brief Function that is executed periodically, with the context given to the periodic task.
+ */
+using task_function = void (*)(void *context);
+
+/**
+ * @brief Executes a function periodically on the shared periodic task thread.
+ *
+ * The deadlines are absolute (start + n * period), so that neither the execution time of the
+ * function nor the rounding of the period to ticks accumulate as drift. A timer expires at every
+ * deadline and submits the execution to a work queue, which is shared by all periodic tasks. So
+ * any number of periodic tasks needs only a single thread stack.
+ *
+ * If an execution is still waiting when the next deadline expires (e.g. because other tasks took
+ * too long), the deadline is skipped and counted as overrun.
+ */
+class periodic_task
+{
+public:
+	periodic_task(task_function function, void *context);
+	~periodic_task();
+
+	// the timer and the work item are referenced by the kernel and can hence not be copied
+	periodic_task(const periodic_task &) = delete;
+	periodic_task &operator=(const periodic_task &) = delete;
+
+	/**
+	 * @brief Starts (or restarts) the periodic execution.
+	 *
+	 * @param period Time between two deadlines.
+	 * @param delay Time until the first deadline.
+	 */
+	void start(std::chrono::microseconds period, std::chrono::microseconds delay);
+
+	void start(std::chrono::microseconds period)
+	{
+		start(period, period);
+	}
+
+	/**
+	 * @brief Stops the periodic execution. Can be called from the function of the task itself.
+	 *
+	 * An execution that is already running is not waited for (only the destructor does so).
+	 */
+	void stop();
+
+	/**
+	 * @brief Number of deadlines that were skipped, because the previous execution was pending.
+	 */
+	uint32_t overruns() const
+	{
+		return overrun_count;
+	}
+
+private:
+	static void expiry_handler(struct k_timer *timer);
+	static void work_handler(struct k_work *work);
+
+	/// Work item of the execution (kept standard-layout to get back to the task).
+	struct task_work {
+		struct k_work work;
+		periodic_task *task;
+	};
+
+	task_function function;
+	void *context;
+
+	struct k_timer timer;
+	task_work execution{};
+
+	int64_t start_ticks = 0;      ///< absolute tick of the first deadline
+	uint64_t period_us = 0U;      ///< in us, so that the rounding to ticks does not accumulate
+	uint64_t deadline_count = 0U; ///< number of expired deadlines since the start
+	uint32_t overrun_count = 0U;
+};
+
+} // namespace os
+
+#endif /* OS_PERIODIC_TASK_HPP */
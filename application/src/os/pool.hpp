@@ -0,0 +1,160 @@
+#ifndef OS_POOL_HPP
+#define OS_POOL_HPP
+
+#include <zephyr/kernel.h>
+#include "os/kernel.hpp"
+#include "util/system_error.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <expected>
+#include <new>
+#include <utility>
+
+namespace os
+{
+
+/**
+ * @brief Fixed number of objects of a type, allocated from a memory slab of the kernel.
+ *
+ * Allocating and freeing takes constant time and cannot fragment, as all blocks have the same
+ * size. Neither needs a heap, so that large objects (e.g. protobuf messages or storage records)
+ * do not have to live on the stack or as globals for the whole runtime. Allocation does not wait
+ * and is hence allowed in ISRs as well.
+ */
+template <typename T, size_t count>
+class pool
+{
+	// the memory slab requires blocks that are a multiple of and aligned to the pointer size
+	static constexpr size_t block_alignment = std::max(alignof(T), sizeof(void *));
+	static constexpr size_t block_size =
+		(sizeof(T) + block_alignment - 1U) / block_alignment * block_alignment;
+
+public:
+	/**
+	 * @brief Owner of an object of the pool, which destroys and frees the object when it is
+	 *        destroyed itself (like std::unique_ptr).
+	 */
+	class handle
+	{
+	public:
+		handle() = default;
+
+		handle(handle &&other) noexcept
+			: slab(std::exchange(other.slab, nullptr)),
+			  object(std::exchange(other.object, nullptr))
+		{
+		}
+
+		handle &operator=(handle &&other) noexcept
+		{
+			if (this != &other) {
+				reset();
+				slab = std::exchange(other.slab, nullptr);
+				object = std::exchange(other.object, nullptr);
+			}
+			return *this;
+		}
+
+		handle(const handle &) = delete;
+		handle &operator=(const handle &) = delete;
+
+		~handle()
+		{
+			reset();
+		}
+
+		/**
+		 * @brief Destroys the object and returns its block to the pool.
+		 */
+		void reset()
+		{
+			if (object != nullptr) {
+				object->~T();
+				k_mem_slab_free(slab, object);
+				object = nullptr;
+			}
+		}
+
+		T *get() const
+		{
+			return object;
+		}
+
+		T &operator*() const
+		{
+			return *object;
+		}
+
+		T *operator->() const
+		{
+			return object;
+		}
+
+		explicit operator bool() const
+		{
+			return object != nullptr;
+		}
+
+	private:
+		friend class pool;
+
+		handle(struct k_mem_slab *slab, T *object) : slab(slab), object(object)
+		{
+		}
+
+		struct k_mem_slab *slab = nullptr;
+		T *object = nullptr;
+	};
+
+	pool()
+	{
+		k_mem_slab_init(&slab, memory.data(), block_size, count);
+	}
+
+	// the memory slab is referenced by the handles of the allocated objects
+	pool(const pool &) = delete;
+	pool &operator=(const pool &) = delete;
+
+	/**
+	 * @brief Allocates a block and constructs an object in it with the given arguments.
+	 *
+	 * @return The handle of the object, or errc::not_enough_memory if all blocks are in use.
+	 */
+	template <typename... argument_types>
+	[[nodiscard]] std::expected<handle, util::error_code>
+	allocate(argument_types &&...arguments)
+	{
+		void *block = nullptr;
+		const auto result = k_mem_slab_alloc(&slab, &block, K_NO_WAIT);
+		if (const auto error = os::result_to_error_code(result)) {
+			return std::unexpected{error};
+		}
+
+		return handle{&slab, new (block) T(std::forward<argument_types>(arguments)...)};
+	}
+
+	/**
+	 * @brief Number of objects that are currently allocated.
+	 */
+	size_t used()
+	{
+		return k_mem_slab_num_used_get(&slab);
+	}
+
+	/**
+	 * @brief Number of objects that can still be allocated.
+	 */
+	size_t available()
+	{
+		return k_mem_slab_num_free_get(&slab);
+	}
+
+private:
+	struct k_mem_slab slab;
+	alignas(block_alignment) std::array<uint8_t, block_size * count> memory;
+};
+
+} // namespace os
+
+#endif /* OS_POOL_HPP */
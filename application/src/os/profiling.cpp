@@ -0,0 +1,62 @@
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include "kernel.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+LOG_MODULE_REGISTER(profiling);
+
+namespace os::profiling
+{
+
+namespace
+{
+struct section {
+	const char *label;
+	uint32_t start; ///< cycles since the cycle counter was started during kernel init
+	uint32_t end;
+};
+
+std::array<section, CONFIG_APP_BOOT_PROFILING_MAX_SECTIONS> sections;
+std::atomic<size_t> section_count{0};
+std::atomic<bool> dumped{false};
+
+} // namespace
+
+void record(const char *label, uint32_t start, uint32_t end)
+{
+	if (dumped.load(std::memory_order_relaxed)) {
+		return;
+	}
+
+	// reserve a slot, so that concurrent threads never write to the same section
+	const auto index = section_count.fetch_add(1, std::memory_order_relaxed);
+	if (index >= sections.size()) {
+		return;
+	}
+
+	sections[index] = {label, start, end};
+}
+
+void dump()
+{
+	if (dumped.exchange(true)) {
+		return;
+	}
+
+	const auto count = section_count.load();
+	if (count > sections.size()) {
+		LOG_WRN("%u sections were dropped, increase CONFIG_APP_BOOT_PROFILING_MAX_SECTIONS",
+			static_cast<unsigned>(count - sections.size()));
+	}
+
+	for (size_t i = 0; i < std::min(count, sections.size()); ++i) {
+		const auto &entry = sections[i];
+		LOG_INF("%-28s at %8u us: %8u cycles (%u us)", entry.label,
+			k_cyc_to_us_floor32(entry.start), entry.end - entry.start,
+			k_cyc_to_us_floor32(entry.end - entry.start));
+	}
+}
+
+} // namespace os::profiling
@@ -0,0 +1,217 @@
+#ifndef OS_SPSC_RING_HPP
+#define OS_SPSC_RING_HPP
+
+#include <zephyr/kernel.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+namespace os
+{
+
+#if defined(CONFIG_DCACHE_LINE_SIZE) && (CONFIG_DCACHE_LINE_SIZE > 0)
+inline constexpr size_t cache_line_size = CONFIG_DCACHE_LINE_SIZE;
+#else
+inline constexpr size_t cache_line_size = 32U;
+#endif
+
+namespace detail
+{
+/**
+ * @brief Wakes up a consumer that waits for elements (only if the ring is blocking).
+ */
+template <bool blocking>
+class ring_signal
+{
+public:
+	void notify()
+	{
+	}
+};
+
+template <>
+class ring_signal<true>
+{
+public:
+	ring_signal()
+	{
+		// binary, as it only signals that elements are available, but not how many
+		k_sem_init(&available, 0, 1);
+	}
+
+	void notify()
+	{
+		k_sem_give(&available);
+	}
+
+	bool wait(k_timeout_t timeout)
+	{
+		return k_sem_take(&available, timeout) == 0;
+	}
+
+private:
+	struct k_sem available;
+};
+} // namespace detail
+
+/**
+ * @brief Lock-free ring buffer for exactly one producer and one consumer (e.g. an ISR and a
+ *        thread).
+ *
+ * The producer only writes the head index and the consumer only writes the tail index, so that
+ * neither needs a lock. The indices reside in separate cache lines to not invalidate each other.
+ * They run freely and are masked with the capacity, which is hence a power of two, and all of it
+ * can be used.
+ *
+ * If blocking is true, the consumer can wait for elements with pop_wait(). The producer then gives
+ * a semaphore with every push (which is allowed in ISRs as well).
+ */
+template <typename T, size_t capacity_, bool blocking = false>
+class spsc_ring
+{
+	static_assert(capacity_ > 0U && (capacity_ & (capacity_ - 1U)) == 0U,
+		      "the capacity must be a power of two");
+	static_assert(std::is_trivially_copyable_v<T>, "the elements are copied into the buffer");
+
+public:
+	static constexpr size_t capacity = capacity_;
+
+	spsc_ring() = default;
+
+	// the producer and the consumer reference the ring
+	spsc_ring(const spsc_ring &) = delete;
+	spsc_ring &operator=(const spsc_ring &) = delete;
+
+	/**
+	 * @brief Appends an element (producer only).
+	 *
+	 * @return False, if the ring is full.
+	 */
+	bool push(const T &element)
+	{
+		return push(std::span<const T>{&element, 1U}) == 1U;
+	}
+
+	/**
+	 * @brief Appends as many of the elements as fit into the ring (producer only).
+	 *
+	 * @return The number of appended elements.
+	 */
+	size_t push(std::span<const T> elements)
+	{
+		const size_t head = head_index.load(std::memory_order_relaxed);
+		const size_t tail = tail_index.load(std::memory_order_acquire);
+
+		const size_t count = std::min(elements.size(), capacity - (head - tail));
+		copy_in(head, elements.first(count));
+		if (count > 0U) {
+			head_index.store(head + count, std::memory_order_release);
+			signal.notify();
+		}
+
+		return count;
+	}
+
+	/**
+	 * @brief Removes the oldest element (consumer only).
+	 *
+	 * @return False, if the ring is empty.
+	 */
+	bool pop(T &element)
+	{
+		return pop(std::span<T>{&element, 1U}) == 1U;
+	}
+
+	/**
+	 * @brief Removes as many of the oldest elements as fit into the given span (consumer only).
+	 *
+	 * @return The number of removed elements.
+	 */
+	size_t pop(std::span<T> elements)
+	{
+		const size_t tail = tail_index.load(std::memory_order_relaxed);
+		const size_t head = head_index.load(std::memory_order_acquire);
+
+		const size_t count = std::min(elements.size(), head - tail);
+		copy_out(tail, elements.first(count));
+		if (count > 0U) {
+			tail_index.store(tail + count, std::memory_order_release);
+		}
+
+		return count;
+	}
+
+	/**
+	 * @brief Removes the oldest elements, waiting until at least one is available (consumer
+	 *        only).
+	 *
+	 * @return The number of removed elements, zero if the timeout expired.
+	 */
+	size_t pop_wait(std::span<T> elements, k_timeout_t timeout)
+		requires blocking
+	{
+		const k_timepoint_t end = sys_timepoint_calc(timeout);
+
+		// the semaphore may still be given from elements that were already removed
+		for (;;) {
+			if (const size_t count = pop(elements)) {
+				return count;
+			}
+			if (!signal.wait(sys_timepoint_timeout(end))) {
+				return pop(elements);
+			}
+		}
+	}
+
+	bool pop_wait(T &element, k_timeout_t timeout)
+		requires blocking
+	{
+		return pop_wait(std::span<T>{&element, 1U}, timeout) == 1U;
+	}
+
+	/**
+	 * @brief Number of elements in the ring (exact only for the producer or the consumer).
+	 */
+	size_t size() const
+	{
+		return head_index.load(std::memory_order_acquire) -
+		       tail_index.load(std::memory_order_acquire);
+	}
+
+	bool empty() const
+	{
+		return size() == 0U;
+	}
+
+private:
+	static constexpr size_t mask = capacity - 1U;
+
+	// the elements may wrap around the end of the buffer, which gives up to two copies
+	void copy_in(size_t index, std::span<const T> elements)
+	{
+		const size_t start = index & mask;
+		const size_t first = std::min(elements.size(), capacity - start);
+		std::copy_n(elements.begin(), first, buffer.begin() + start);
+		std::copy(elements.begin() + first, elements.end(), buffer.begin());
+	}
+
+	void copy_out(size_t index, std::span<T> elements) const
+	{
+		const size_t start = index & mask;
+		const size_t first = std::min(elements.size(), capacity - start);
+		std::copy_n(buffer.begin() + start, first, elements.begin());
+		std::copy_n(buffer.begin(), elements.size() - first, elements.begin() + first);
+	}
+
+	alignas(cache_line_size) std::atomic<size_t> head_index{0U}; ///< written by the producer
+	alignas(cache_line_size) std::atomic<size_t> tail_index{0U}; ///< written by the consumer
+	alignas(cache_line_size) std::array<T, capacity> buffer{};
+	[[no_unique_address]] detail::ring_signal<blocking> signal{};
+};
+
+} // namespace os
+
+#endif /* OS_SPSC_RING_HPP */
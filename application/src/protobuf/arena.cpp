@@ -0,0 +1,56 @@
+#include "arena.hpp"
+
+namespace protobuf
+{
+
+void *arena::allocate(size_t size, size_t alignment)
+{
+	const auto base = reinterpret_cast<uintptr_t>(memory.data());
+	const auto start = ((base + offset + alignment - 1U) & ~(alignment - 1U)) - base;
+
+	if ((start > memory.size()) || (size > memory.size() - start)) {
+		return nullptr;
+	}
+
+	offset = start + size;
+	return memory.data() + start;
+}
+
+namespace detail
+{
+
+bool decode_string(pb_istream_t *stream, arena &memory, std::span<const uint8_t> &value)
+{
+	// the callback of a string field gets a substream that is limited to the string
+	const size_t length = stream->bytes_left;
+	auto *const data = static_cast<uint8_t *>(memory.allocate(length));
+	if ((data == nullptr) || !pb_read(stream, data, length)) {
+		return false;
+	}
+
+	value = {data, length};
+	return true;
+}
+
+} // namespace detail
+
+bool string_field::decode(pb_istream_t *stream, const pb_field_t *, void **arg)
+{
+	auto &self = *static_cast<string_field *>(*arg);
+	return detail::decode_string(stream, *self.memory, self.data);
+}
+
+bool string_field::encode(pb_ostream_t *stream, const pb_field_t *field, void *const *arg)
+{
+	const auto &self = *static_cast<const string_field *>(*arg);
+
+	// like for static fields of proto3, empty strings are not encoded
+	if (self.data.empty()) {
+		return true;
+	}
+
+	return pb_encode_tag_for_field(stream, field) &&
+	       pb_encode_string(stream, self.data.data(), self.data.size());
+}
+
+} // namespace protobuf
@@ -0,0 +1,434 @@
+#ifndef PROTOBUF_ARENA_HPP
+#define PROTOBUF_ARENA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <pb_decode.h>
+#include <pb_encode.h>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace protobuf
+{
+
+/**
+ * @brief Fixed memory provided by the caller, from which variable-length fields are allocated.
+ *
+ * Allocations are never freed individually, the whole arena is reset at once (e.g. before the
+ * next message gets decoded). Thereby, the memory used by a decoded message depends on the
+ * actual content of the message and not on the worst case.
+ */
+class arena
+{
+public:
+	explicit arena(std::span<uint8_t> memory) : memory{memory}
+	{
+	}
+
+	arena(const arena &) = delete;
+	arena &operator=(const arena &) = delete;
+
+	/**
+	 * @brief Allocates memory for an object or a string.
+	 *
+	 * @return The allocated memory, or nullptr if the arena has not enough space left.
+	 */
+	void *allocate(size_t size, size_t alignment = 1U);
+
+	/**
+	 * @brief Frees all allocations. Everything that was decoded into the arena becomes invalid.
+	 */
+	void reset()
+	{
+		offset = 0U;
+	}
+
+	size_t used() const
+	{
+		return offset;
+	}
+
+	size_t capacity() const
+	{
+		return memory.size();
+	}
+
+private:
+	std::span<uint8_t> memory;
+	size_t offset = 0U;
+};
+
+/**
+ * @brief Singly-linked list of chunks in an arena, which grows without relocating its elements.
+ *
+ * The chunks double in size, so that at most half of the last chunk is unused.
+ */
+template <typename T>
+class arena_list
+{
+	static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+		      "the elements are never destroyed");
+
+	struct chunk {
+		chunk *next;
+		size_t count;
+		size_t capacity;
+
+		T *items()
+		{
+			auto *const base = reinterpret_cast<uint8_t *>(this);
+			return reinterpret_cast<T *>(base + items_offset);
+		}
+	};
+
+	/// The elements follow the header of a chunk.
+	static constexpr size_t items_offset =
+		(sizeof(chunk) + alignof(T) - 1U) & ~(alignof(T) - 1U);
+	static constexpr size_t first_chunk_capacity = 4U;
+	static constexpr size_t max_chunk_capacity = 64U;
+
+public:
+	class iterator
+	{
+	public:
+		using value_type = T;
+		using difference_type = ptrdiff_t;
+
+		iterator() = default;
+		iterator(chunk *current) : current{current}
+		{
+		}
+
+		const T &operator*() const
+		{
+			return current->items()[index];
+		}
+
+		iterator &operator++()
+		{
+			if (++index == current->count) {
+				current = current->next;
+				index = 0U;
+			}
+			return *this;
+		}
+
+		iterator operator++(int)
+		{
+			auto previous = *this;
+			++*this;
+			return previous;
+		}
+
+		bool operator==(const iterator &other) const = default;
+
+	private:
+		chunk *current = nullptr;
+		size_t index = 0U;
+	};
+
+	/**
+	 * @brief Appends an element.
+	 *
+	 * @return False, if the arena has not enough space left.
+	 */
+	bool push_back(arena &memory, const T &value)
+	{
+		if ((last == nullptr) || (last->count == last->capacity)) {
+			const size_t capacity = (last == nullptr) ? first_chunk_capacity
+				: std::min(last->capacity * 2U, max_chunk_capacity);
+			void *allocation = memory.allocate(items_offset + capacity * sizeof(T),
+							   std::max(alignof(chunk), alignof(T)));
+			if (allocation == nullptr) {
+				return false;
+			}
+
+			auto *const next = new (allocation) chunk{nullptr, 0U, capacity};
+			if (last == nullptr) {
+				first = next;
+			} else {
+				last->next = next;
+			}
+			last = next;
+		}
+
+		last->items()[last->count++] = value;
+		element_count++;
+		return true;
+	}
+
+	void clear()
+	{
+		first = last = nullptr;
+		element_count = 0U;
+	}
+
+	size_t size() const
+	{
+		return element_count;
+	}
+
+	bool empty() const
+	{
+		return element_count == 0U;
+	}
+
+	iterator begin() const
+	{
+		return iterator{first};
+	}
+
+	iterator end() const
+	{
+		return iterator{};
+	}
+
+private:
+	chunk *first = nullptr;
+	chunk *last = nullptr;
+	size_t element_count = 0U;
+};
+
+/**
+ * @brief A string or bytes field (callback field of nanopb) that is decoded into an arena.
+ *
+ * Set the callback of the field to decoder() before decoding, or to encoder() before encoding.
+ */
+class string_field
+{
+public:
+	explicit string_field(arena &memory) : memory{&memory}
+	{
+	}
+
+	std::string_view value() const
+	{
+		return {reinterpret_cast<const char *>(data.data()), data.size()};
+	}
+
+	std::span<const uint8_t> bytes() const
+	{
+		return data;
+	}
+
+	/**
+	 * @brief Sets the value to be encoded (not copied, so it must outlive the encoding).
+	 */
+	void assign(std::span<const uint8_t> value)
+	{
+		data = value;
+	}
+
+	void assign(std::string_view value)
+	{
+		data = {reinterpret_cast<const uint8_t *>(value.data()), value.size()};
+	}
+
+	pb_callback_t decoder()
+	{
+		pb_callback_t callback{};
+		callback.funcs.decode = decode;
+		callback.arg = this;
+		return callback;
+	}
+
+	pb_callback_t encoder() const
+	{
+		pb_callback_t callback{};
+		callback.funcs.encode = encode;
+		callback.arg = const_cast<string_field *>(this);
+		return callback;
+	}
+
+private:
+	static bool decode(pb_istream_t *stream, const pb_field_t *field, void **arg);
+	static bool encode(pb_ostream_t *stream, const pb_field_t *field, void *const *arg);
+
+	arena *memory;
+	std::span<const uint8_t> data{};
+};
+
+namespace detail
+{
+/// Reads a string of the length of the (sub)stream into the arena.
+bool decode_string(pb_istream_t *stream, arena &memory, std::span<const uint8_t> &value);
+} // namespace detail
+
+/**
+ * @brief A repeated field (callback field of nanopb) whose elements are decoded into an arena.
+ *
+ * Numeric elements (T is an integer, floating point or enum type matching the field type) are
+ * encoded packed, like nanopb does for proto3. Repeated strings or bytes use std::string_view.
+ */
+template <typename T>
+class repeated_field
+{
+public:
+	explicit repeated_field(arena &memory) : memory{&memory}
+	{
+	}
+
+	const arena_list<T> &values() const
+	{
+		return elements;
+	}
+
+	/**
+	 * @brief Appends an element to be encoded (strings are not copied into the arena).
+	 *
+	 * @return False, if the arena has not enough space left.
+	 */
+	bool push_back(const T &value)
+	{
+		return elements.push_back(*memory, value);
+	}
+
+	pb_callback_t decoder()
+	{
+		elements.clear();
+
+		pb_callback_t callback{};
+		callback.funcs.decode = decode;
+		callback.arg = this;
+		return callback;
+	}
+
+	pb_callback_t encoder() const
+	{
+		pb_callback_t callback{};
+		callback.funcs.encode = encode;
+		callback.arg = const_cast<repeated_field *>(this);
+		return callback;
+	}
+
+private:
+	static constexpr bool is_string = std::is_same_v<T, std::string_view>;
+
+	// packed arrays call the callback once per element with a substream of the whole array
+	static bool decode(pb_istream_t *stream, const pb_field_t *field, void **arg)
+	{
+		auto &self = *static_cast<repeated_field *>(*arg);
+
+		if constexpr (is_string) {
+			std::span<const uint8_t> value;
+			return detail::decode_string(stream, *self.memory, value) &&
+			       self.push_back({reinterpret_cast<const char *>(value.data()),
+					       value.size()});
+		} else {
+			T value{};
+			return decode_value(stream, field, value) && self.push_back(value);
+		}
+	}
+
+	static bool encode(pb_ostream_t *stream, const pb_field_t *field, void *const *arg)
+	{
+		const auto &self = *static_cast<const repeated_field *>(*arg);
+
+		if constexpr (is_string) {
+			for (const std::string_view value : self.elements) {
+				const auto *const text =
+					reinterpret_cast<const pb_byte_t *>(value.data());
+				if (!pb_encode_tag_for_field(stream, field) ||
+				    !pb_encode_string(stream, text, value.size())) {
+					return false;
+				}
+			}
+			return true;
+		} else {
+			if (self.elements.empty()) {
+				return true;
+			}
+
+			// the length of a packed array precedes its elements
+			pb_ostream_t sizing = PB_OSTREAM_SIZING;
+			for (const auto &value : self.elements) {
+				(void)encode_value(&sizing, field, value);
+			}
+
+			if (!pb_encode_tag(stream, PB_WT_STRING, field->tag) ||
+			    !pb_encode_varint(stream, sizing.bytes_written)) {
+				return false;
+			}
+			for (const auto &value : self.elements) {
+				if (!encode_value(stream, field, value)) {
+					return false;
+				}
+			}
+			return true;
+		}
+	}
+
+	static bool decode_value(pb_istream_t *stream, const pb_field_t *field, T &value)
+	{
+		switch (PB_LTYPE(field->type)) {
+		case PB_LTYPE_BOOL: {
+			bool flag = false;
+			const bool status = pb_decode_bool(stream, &flag);
+			value = static_cast<T>(flag);
+			return status;
+		}
+		case PB_LTYPE_VARINT:
+		case PB_LTYPE_UVARINT: {
+			uint64_t raw = 0U;
+			const bool status = pb_decode_varint(stream, &raw);
+			value = static_cast<T>(raw);
+			return status;
+		}
+		case PB_LTYPE_SVARINT: {
+			int64_t raw = 0;
+			const bool status = pb_decode_svarint(stream, &raw);
+			value = static_cast<T>(raw);
+			return status;
+		}
+		case PB_LTYPE_FIXED32:
+			if constexpr (sizeof(T) == sizeof(uint32_t)) {
+				return pb_decode_fixed32(stream, &value);
+			}
+			return false;
+		case PB_LTYPE_FIXED64:
+			if constexpr (sizeof(T) == sizeof(uint64_t)) {
+				return pb_decode_fixed64(stream, &value);
+			}
+			return false;
+		default:
+			return false;
+		}
+	}
+
+	static bool encode_value(pb_ostream_t *stream, const pb_field_t *field, const T &value)
+	{
+		switch (PB_LTYPE(field->type)) {
+		case PB_LTYPE_BOOL:
+		case PB_LTYPE_UVARINT:
+			return pb_encode_varint(stream, static_cast<uint64_t>(value));
+		case PB_LTYPE_VARINT:
+			// negative values are sign extended to 64 bit
+			return pb_encode_varint(stream,
+						static_cast<uint64_t>(static_cast<int64_t>(value)));
+		case PB_LTYPE_SVARINT:
+			return pb_encode_svarint(stream, static_cast<int64_t>(value));
+		case PB_LTYPE_FIXED32:
+			if constexpr (sizeof(T) == sizeof(uint32_t)) {
+				return pb_encode_fixed32(stream, &value);
+			}
+			return false;
+		case PB_LTYPE_FIXED64:
+			if constexpr (sizeof(T) == sizeof(uint64_t)) {
+				return pb_encode_fixed64(stream, &value);
+			}
+			return false;
+		default:
+			return false;
+		}
+	}
+
+	arena *memory;
+	arena_list<T> elements{};
+};
+
+} // namespace protobuf
+
+#endif /* PROTOBUF_ARENA_HPP */
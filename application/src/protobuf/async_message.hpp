@@ -0,0 +1,28 @@
+#ifndef PROTOBUF_ASYNC_MESSAGE_HPP
+#define PROTOBUF_ASYNC_MESSAGE_HPP
+
+#include "os/coroutine.hpp"
+#include "protobuf_message.hpp"
+
+namespace protobuf
+{
+
+// Awaitable encoding and decoding for os::task coroutines. They are executed on the offload work
+// queue, so that the stack of the coroutine work queue does not need to fit the nanopb encoder
+// and decoder. The message and the buffer must outlive the co_await.
+
+template <typename type, size_t max_size>
+auto async_encode(const message<type, max_size> &message, std::span<uint8_t> buffer)
+{
+	return os::offload{[&message, buffer] { return message.encode(buffer); }};
+}
+
+template <typename type, size_t max_size>
+auto async_decode(message<type, max_size> &message, std::span<const uint8_t> buffer)
+{
+	return os::offload{[&message, buffer] { return message.decode(buffer); }};
+}
+
+} // namespace protobuf
+
+#endif /* PROTOBUF_ASYNC_MESSAGE_HPP */
@@ -1,31 +1,18 @@
 #include "protobuf_error.hpp"
-#include <zephyr/logging/log.h>
+#include <array>
 
 namespace protobuf
 {
 
 namespace
 {
-struct error_category : public util::error_category {
-	[[nodiscard]] const char *name() const noexcept override
-	{
-		return "protobuf_message";
-	}
+constexpr std::array<util::error_message, 2> messages{{
+	{static_cast<int>(error_code::encode_failure), "Encode failure"},
+	{static_cast<int>(error_code::decode_failure), "Decode failure"},
+}};
+static_assert(util::is_valid_message_table(messages));
 
-	[[nodiscard]] const char *message(int ev) const noexcept override
-	{
-		switch (static_cast<error_code>(ev)) {
-		case error_code::encode_failure:
-			return "Encode failure";
-		case error_code::decode_failure:
-			return "Decode failure";
-		}
-
-		return "Unknown error";
-	}
-};
-
-const error_category the_error_category{};
+constinit const util::error_category the_error_category{"protobuf_message", messages};
 
 } // namespace
 
@@ -1,5 +1,8 @@
 #include "protobuf_message.hpp"
 #include <zephyr/logging/log.h>
+#include "os/kernel.hpp"
+#include <pb_decode.h>
+#include <pb_encode.h>
 
 namespace protobuf
 {
@@ -8,4 +11,47 @@ namespace protobuf
 // protobuf_message this needs to be done in a separate module file.
 LOG_MODULE_REGISTER(protobuf_message, LOG_LEVEL_DBG);
 
+namespace detail
+{
+
+std::expected<std::span<uint8_t>, util::error_code>
+encode(const pb_msgdesc_t &descriptor, const void *message, std::span<uint8_t> buffer)
+{
+	const os::profiling::scoped_timer timer{"protobuf encode"};
+
+	// create output stream and encode the message into it
+	pb_ostream_t stream = pb_ostream_from_buffer(buffer.data(), buffer.size());
+	const auto status = pb_encode(&stream, &descriptor, message);
+
+	if (!status) {
+		LOG_WRN("Encoding failed: %s\n", PB_GET_ERROR(&stream));
+		return std::unexpected{error_code::encode_failure};
+	}
+
+	return std::span<uint8_t>{buffer.data(), stream.bytes_written};
+}
+
+util::error_code decode(const pb_msgdesc_t &descriptor, void *message,
+			std::span<const uint8_t> buffer)
+{
+	const os::profiling::scoped_timer timer{"protobuf decode"};
+
+	// create input stream and decode message from it
+	pb_istream_t stream = pb_istream_from_buffer(buffer.data(), buffer.size());
+	const auto status = pb_decode(&stream, &descriptor, message);
+
+	if (!status) {
+		LOG_WRN("Decoding failed: %s\n", PB_GET_ERROR(&stream));
+		return error_code::decode_failure;
+	}
+	return {};
+}
+
+void log_codec_failure(const char *operation, const char *reason)
+{
+	LOG_WRN("%s failed: %s\n", operation, reason);
+}
+
+} // namespace detail
+
 } // namespace protobuf
@@ -1,17 +1,34 @@
 #ifndef PROTOBUF_PROTOBUF_MESSAGE_HPP
 #define PROTOBUF_PROTOBUF_MESSAGE_HPP
 
-#include <zephyr/logging/log.h>
+#include "os/kernel.hpp"
 #include "protobuf_error.hpp"
+#include "scalar_codec.hpp"
 #include "util/system_error.hpp"
 #include <expected>
-#include <pb_decode.h>
-#include <pb_encode.h>
+#include <pb.h>
 #include <span>
 
 namespace protobuf
 {
 
+namespace detail
+{
+// The type-independent encoding and decoding is shared by all message types, so that every
+// instantiation of protobuf::message only adds a thin wrapper.
+
+std::expected<std::span<uint8_t>, util::error_code>
+encode(const pb_msgdesc_t &descriptor, const void *message, std::span<uint8_t> buffer);
+
+util::error_code decode(const pb_msgdesc_t &descriptor, void *message,
+			std::span<const uint8_t> buffer);
+
+/**
+ * @brief Logs a failed encoding or decoding of the scalar codec like the ones of nanopb.
+ */
+void log_codec_failure(const char *operation, const char *reason);
+} // namespace detail
+
 /**
  * @brief Template class for handling encoding and decoding of a certain protobuf message.
  */
@@ -50,18 +67,16 @@ public:
 	 */
 	std::expected<std::span<uint8_t>, util::error_code> encode(std::span<uint8_t> buffer) const
 	{
-		LOG_MODULE_DECLARE(protobuf_message); // needed for logging in inline functions
-
-		// create output stream and encode the message into it
-		pb_ostream_t stream = pb_ostream_from_buffer(buffer.data(), buffer.size());
-		const auto status = pb_encode(&stream, &message_definition, &pb_message);
-
-		if (!status) {
-			LOG_WRN("Encoding failed: %s\n", PB_GET_ERROR(&stream));
-			return std::unexpected{error_code::encode_failure};
+		if constexpr (use_codec) {
+			const os::profiling::scoped_timer timer{"protobuf encode"};
+			const auto encoded = codec<message_type>::encode(pb_message, buffer);
+			if (!encoded) {
+				detail::log_codec_failure("Encoding", "stream full");
+			}
+			return encoded;
+		} else {
+			return detail::encode(message_definition, &pb_message, buffer);
 		}
-
-		return std::span<uint8_t>{buffer.data(), stream.bytes_written};
 	}
 
 	/**
@@ -70,22 +85,33 @@ public:
 	 * @param buffer A span of the buffer from which the message should be decoded.
 	 * @return Error code showing the decoding success or a potential error.
 	 */
-	util::error_code decode(std::span<uint8_t> buffer)
+	util::error_code decode(std::span<const uint8_t> buffer)
 	{
-		LOG_MODULE_DECLARE(protobuf_message);
-
-		// create input stream and decode message from it
-		pb_istream_t stream = pb_istream_from_buffer(buffer.data(), buffer.size());
-		const auto status = pb_decode(&stream, &message_definition, &pb_message);
-
-		if (!status) {
-			LOG_WRN("Decoding failed: %s\n", PB_GET_ERROR(&stream));
-			return error_code::decode_failure;
+		if constexpr (use_codec) {
+			const os::profiling::scoped_timer timer{"protobuf decode"};
+			const char *reason = nullptr;
+			const auto error = codec<message_type>::decode(buffer, pb_message, &reason);
+			if (error) {
+				detail::log_codec_failure("Decoding", reason);
+			}
+			return error;
+		} else {
+			return detail::decode(message_definition, &pb_message, buffer);
 		}
-		return {};
 	}
 
 private:
+	static_assert(requires { codec<message_type>::available; },
+		      "declare the codec of the message (PROTOBUF_SCALAR_CODEC or "
+		      "PROTOBUF_NANOPB_CODEC) next to its generated header");
+
+	/// Messages with a codec (see PROTOBUF_SCALAR_CODEC) bypass the nanopb encoder/decoder.
+#ifdef CONFIG_APP_PROTOBUF_SCALAR_CODEC
+	static constexpr bool use_codec = codec<message_type>::available;
+#else
+	static constexpr bool use_codec = false;
+#endif
+
 	message_type pb_message; ///< The protobuf message as given per template parameter.
 	pb_msgdesc_s const &message_definition; ///< The message definition of the protobuf message
 						///< (needed for encoding and decoding).
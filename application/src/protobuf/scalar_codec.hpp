@@ -0,0 +1,685 @@
+#ifndef PROTOBUF_SCALAR_CODEC_HPP
+#define PROTOBUF_SCALAR_CODEC_HPP
+
+#include "protobuf_error.hpp"
+#include "util/system_error.hpp"
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace protobuf
+{
+
+/**
+ * @brief Codec that replaces the generic, descriptor-driven nanopb encoder/decoder of a message.
+ *
+ * The primary template is only declared: every message type that is used with protobuf::message
+ * needs a specialization, either with straight-line code via PROTOBUF_SCALAR_CODEC or one that
+ * keeps nanopb via PROTOBUF_NANOPB_CODEC (see below). A translation unit that sees the message
+ * type without its codec thereby fails to compile, instead of instantiating protobuf::message
+ * with another encoder/decoder than the others.
+ */
+template <typename message_type>
+struct codec;
+
+namespace detail
+{
+
+enum class wire_type : uint8_t {
+	varint = 0,
+	fixed64 = 1,
+	length_delimited = 2,
+	fixed32 = 5,
+};
+
+/// Field types of nanopb (the LTYPE of the field list) that are supported by the scalar codec.
+enum class scalar_kind : uint8_t {
+	boolean,
+	int32,
+	uint32,
+	sint32,
+	int64,
+	uint64,
+	sint64,
+	enumeration,
+	unsigned_enumeration,
+	fixed32,
+	sfixed32,
+	float32,
+	fixed64,
+	sfixed64,
+	float64,
+	unsupported,
+};
+
+constexpr wire_type wire_type_of(scalar_kind kind)
+{
+	switch (kind) {
+	case scalar_kind::fixed32:
+	case scalar_kind::sfixed32:
+	case scalar_kind::float32:
+		return wire_type::fixed32;
+	case scalar_kind::fixed64:
+	case scalar_kind::sfixed64:
+	case scalar_kind::float64:
+		return wire_type::fixed64;
+	default:
+		return wire_type::varint;
+	}
+}
+
+constexpr size_t varint_size(uint64_t value)
+{
+	size_t size = 1U;
+	while (value >= 0x80U) {
+		value >>= 7;
+		size++;
+	}
+	return size;
+}
+
+/**
+ * @brief Bounds-checked writer of the protobuf wire format into a buffer.
+ */
+class writer
+{
+public:
+	explicit writer(std::span<uint8_t> buffer)
+		: position{buffer.data()}, end{position + buffer.size()}
+	{
+	}
+
+	template <size_t size>
+	void bytes(const std::array<uint8_t, size> &data)
+	{
+		if (static_cast<size_t>(end - position) < size) {
+			overflow = true;
+			return;
+		}
+		std::memcpy(position, data.data(), size);
+		position += size;
+	}
+
+	void varint(uint64_t value)
+	{
+		while (value >= 0x80U) {
+			byte(static_cast<uint8_t>(value | 0x80U));
+			value >>= 7;
+		}
+		byte(static_cast<uint8_t>(value));
+	}
+
+	void fixed32(uint32_t value)
+	{
+		bytes(std::array<uint8_t, 4>{
+			static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8),
+			static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 24)});
+	}
+
+	void fixed64(uint64_t value)
+	{
+		fixed32(static_cast<uint32_t>(value));
+		fixed32(static_cast<uint32_t>(value >> 32));
+	}
+
+	bool failed() const
+	{
+		return overflow;
+	}
+
+	const uint8_t *current() const
+	{
+		return position;
+	}
+
+private:
+	void byte(uint8_t value)
+	{
+		if (position == end) {
+			overflow = true;
+			return;
+		}
+		*position++ = value;
+	}
+
+	uint8_t *position;
+	uint8_t *end;
+	bool overflow = false;
+};
+
+/**
+ * @brief Bounds-checked reader of the protobuf wire format from a buffer.
+ *
+ * Varints are read and checked like pb_decode_varint() and pb_decode_varint32() of nanopb, and
+ * a failure keeps the same reason as PB_GET_ERROR().
+ */
+class reader
+{
+public:
+	explicit reader(std::span<const uint8_t> buffer)
+		: position{buffer.data()}, end{position + buffer.size()}
+	{
+	}
+
+	bool empty() const
+	{
+		return position == end;
+	}
+
+	uint64_t varint()
+	{
+		uint64_t value = 0U;
+		uint8_t byte;
+		unsigned shift = 0U;
+		do {
+			if (!next(byte)) {
+				return 0U;
+			}
+			// the tenth byte may only hold the highest bit
+			if (shift >= 63U && (byte & 0xFEU) != 0U) {
+				fail("varint overflow");
+				return 0U;
+			}
+			value |= static_cast<uint64_t>(byte & 0x7FU) << shift;
+			shift += 7U;
+		} while ((byte & 0x80U) != 0U);
+		return value;
+	}
+
+	/**
+	 * @brief Reads a varint of at most 32 bits, which may be padded with zeros or sign extended
+	 *        to 64 bits (keys, lengths and booleans).
+	 */
+	uint32_t varint32()
+	{
+		uint32_t value = 0U;
+		uint8_t byte;
+		unsigned shift = 0U;
+		do {
+			if (!next(byte)) {
+				return 0U;
+			}
+			if (shift >= 32U) {
+				const uint8_t sign_extension = (shift < 63U) ? 0xFFU : 0x01U;
+				const bool valid_extension =
+					((byte & 0x7FU) == 0U) ||
+					(((value >> 31) != 0U) && (byte == sign_extension));
+				if (shift >= 64U || !valid_extension) {
+					fail("varint overflow");
+					return 0U;
+				}
+			} else if (shift == 28U) {
+				if ((byte & 0x70U) != 0U && (byte & 0x78U) != 0x78U) {
+					fail("varint overflow");
+					return 0U;
+				}
+				value |= static_cast<uint32_t>(byte & 0x0FU) << shift;
+			} else {
+				value |= static_cast<uint32_t>(byte & 0x7FU) << shift;
+			}
+			shift += 7U;
+		} while ((byte & 0x80U) != 0U);
+		return value;
+	}
+
+	uint32_t fixed32()
+	{
+		if (static_cast<size_t>(end - position) < 4U) {
+			position = end;
+			fail("io error");
+			return 0U;
+		}
+
+		const uint32_t value = position[0] | (position[1] << 8) | (position[2] << 16) |
+				       (static_cast<uint32_t>(position[3]) << 24);
+		position += 4;
+		return value;
+	}
+
+	uint64_t fixed64()
+	{
+		const uint64_t low = fixed32();
+		return low | (static_cast<uint64_t>(fixed32()) << 32);
+	}
+
+	/**
+	 * @brief Skips the value of an unknown field.
+	 */
+	void skip(uint8_t type)
+	{
+		switch (static_cast<wire_type>(type)) {
+		case wire_type::varint: {
+			// like pb_skip_varint(), without a limit of the length
+			uint8_t byte;
+			while (next(byte) && (byte & 0x80U) != 0U) {
+			}
+			break;
+		}
+		case wire_type::fixed64:
+			(void)fixed64();
+			break;
+		case wire_type::fixed32:
+			(void)fixed32();
+			break;
+		case wire_type::length_delimited: {
+			const uint32_t length = varint32();
+			if (failed()) {
+				return;
+			}
+			if (length > static_cast<size_t>(end - position)) {
+				position = end;
+				fail("io error");
+				return;
+			}
+			position += length;
+			break;
+		}
+		default:
+			fail("invalid wire_type");
+			break;
+		}
+	}
+
+	/**
+	 * @brief Fails the decoding, if it has not failed yet.
+	 *
+	 * @param why A static string like the error messages of nanopb.
+	 */
+	void fail(const char *why)
+	{
+		if (reason == nullptr) {
+			reason = why;
+		}
+	}
+
+	bool failed() const
+	{
+		return reason != nullptr;
+	}
+
+	/**
+	 * @return Why the decoding failed, nullptr if it did not fail.
+	 */
+	const char *error() const
+	{
+		return reason;
+	}
+
+private:
+	bool next(uint8_t &byte)
+	{
+		if (position == end) {
+			fail("io error");
+			return false;
+		}
+		byte = *position++;
+		return true;
+	}
+
+	const uint8_t *position;
+	const uint8_t *end;
+	const char *reason = nullptr;
+};
+
+template <typename T>
+constexpr bool is_zero(T value)
+{
+	// like nanopb, proto3 fields are only omitted if all their bits are zero (-0.0 is encoded)
+	if constexpr (sizeof(T) == 1U) {
+		return std::bit_cast<uint8_t>(value) == 0U;
+	} else if constexpr (sizeof(T) == 2U) {
+		return std::bit_cast<uint16_t>(value) == 0U;
+	} else if constexpr (sizeof(T) == 4U) {
+		return std::bit_cast<uint32_t>(value) == 0U;
+	} else {
+		return std::bit_cast<uint64_t>(value) == 0U;
+	}
+}
+
+template <typename T>
+constexpr bool fits(int64_t value)
+{
+	return (value >= std::numeric_limits<T>::min()) && (value <= std::numeric_limits<T>::max());
+}
+
+template <typename member_pointer>
+struct member_of;
+
+template <typename struct_type, typename member_type>
+struct member_of<member_type struct_type::*> {
+	using type = member_type;
+};
+
+/// Signed integer of a size, like the integer sizes of nanopb (int_size option).
+template <size_t size>
+using signed_integer = std::conditional_t<
+	size == 1U, int8_t,
+	std::conditional_t<size == 2U, int16_t, std::conditional_t<size == 4U, int32_t, int64_t>>>;
+
+/// Integer of the size of an enum field.
+template <typename enum_type, bool is_unsigned>
+using enum_integer = std::conditional_t<is_unsigned,
+					std::make_unsigned_t<signed_integer<sizeof(enum_type)>>,
+					signed_integer<sizeof(enum_type)>>;
+
+/**
+ * @brief A static, singular (proto3) or required (proto2) scalar field of a message.
+ *
+ * @tparam member Pointer to the member of the nanopb struct.
+ * @tparam tag The field number.
+ * @tparam kind The type of the field in the .proto file.
+ * @tparam required Required fields are always encoded, singular fields only if they are not zero.
+ */
+template <auto member, uint32_t tag, scalar_kind kind, bool required>
+struct scalar_field {
+	static constexpr bool supported = (kind != scalar_kind::unsupported);
+	static constexpr bool is_required = required;
+
+	static constexpr bool is_signed_varint = (kind == scalar_kind::int32) ||
+						 (kind == scalar_kind::int64) ||
+						 (kind == scalar_kind::enumeration);
+	static constexpr bool is_unsigned_varint = (kind == scalar_kind::uint32) ||
+						   (kind == scalar_kind::uint64) ||
+						   (kind == scalar_kind::unsigned_enumeration);
+	static constexpr bool is_zigzag = (kind == scalar_kind::sint32) ||
+					  (kind == scalar_kind::sint64);
+
+	using value_type = typename member_of<decltype(member)>::type;
+
+	/// proto3 enums are open, so an enum field can hold values without an enumerator, which a C
+	/// enum without a fixed underlying type cannot represent in C++. Like nanopb, enum fields
+	/// are therefore loaded and stored as integers of their size.
+	using integer_type =
+		std::conditional_t<std::is_enum_v<value_type>,
+				   enum_integer<value_type, is_unsigned_varint>, value_type>;
+
+	/// The key of the field, encoded at compile time.
+	static constexpr auto key = [] {
+		uint64_t value = (static_cast<uint64_t>(tag) << 3) |
+				 static_cast<uint8_t>(wire_type_of(kind));
+		std::array<uint8_t, varint_size((static_cast<uint64_t>(tag) << 3) | 7U)> bytes{};
+		for (auto &byte : bytes) {
+			const uint8_t more = (value >= 0x80U) ? 0x80U : 0U;
+			byte = static_cast<uint8_t>((value & 0x7FU) | more);
+			value >>= 7;
+		}
+		return bytes;
+	}();
+
+	template <typename message_type>
+	static void encode(const message_type &message, writer &out)
+	{
+		const auto value = load(message.*member);
+		if (!required && is_zero(value)) {
+			return;
+		}
+
+		out.bytes(key);
+		if constexpr (kind == scalar_kind::boolean) {
+			out.varint(value ? 1U : 0U);
+		} else if constexpr (is_signed_varint) {
+			// negative values are sign extended to 64 bit (10 bytes on the wire)
+			out.varint(static_cast<uint64_t>(static_cast<int64_t>(value)));
+		} else if constexpr (is_unsigned_varint) {
+			out.varint(static_cast<uint64_t>(value));
+		} else if constexpr (is_zigzag) {
+			const auto signed_value = static_cast<int64_t>(value);
+			out.varint((static_cast<uint64_t>(signed_value) << 1) ^
+				   static_cast<uint64_t>(signed_value >> 63));
+		} else if constexpr (wire_type_of(kind) == wire_type::fixed32) {
+			out.fixed32(std::bit_cast<uint32_t>(value));
+		} else {
+			out.fixed64(std::bit_cast<uint64_t>(value));
+		}
+	}
+
+	/**
+	 * @brief Decodes the value of the field like pb_decode(), if the key belongs to it.
+	 *
+	 * @return Whether the key belongs to this field.
+	 */
+	template <typename message_type>
+	static bool decode(uint32_t number, uint8_t type, reader &in, message_type &message)
+	{
+		if (number != tag) {
+			return false;
+		}
+
+		if (type != static_cast<uint8_t>(wire_type_of(kind))) {
+			in.fail("wrong wire type");
+			return true;
+		}
+
+		if constexpr (kind == scalar_kind::boolean) {
+			// booleans are read as 32 bit varints by nanopb
+			store(message.*member, in.varint32() != 0U);
+		} else if constexpr (is_signed_varint) {
+			// like nanopb, varints of fields up to 32 bits are truncated to 32 bits, as
+			// some encoders write negative int32 values with only 32 bits
+			const auto raw = in.varint();
+			const auto value = (sizeof(integer_type) == sizeof(int64_t))
+						   ? static_cast<int64_t>(raw)
+						   : int64_t{static_cast<int32_t>(raw)};
+			check_range(in, fits<integer_type>(value));
+			store(message.*member, value);
+		} else if constexpr (is_unsigned_varint) {
+			const auto value = in.varint();
+			check_range(in, value <= std::numeric_limits<integer_type>::max());
+			store(message.*member, value);
+		} else if constexpr (is_zigzag) {
+			const auto raw = in.varint();
+			const auto value = static_cast<int64_t>((raw >> 1) ^ (~(raw & 1U) + 1U));
+			check_range(in, fits<integer_type>(value));
+			store(message.*member, value);
+		} else if constexpr (wire_type_of(kind) == wire_type::fixed32) {
+			message.*member = std::bit_cast<value_type>(in.fixed32());
+		} else {
+			message.*member = std::bit_cast<value_type>(in.fixed64());
+		}
+		return true;
+	}
+
+private:
+	template <typename field_type>
+	static auto load(const field_type &field)
+	{
+		if constexpr (std::is_enum_v<field_type>) {
+			integer_type value;
+			std::memcpy(&value, &field, sizeof(value));
+			return value;
+		} else {
+			return field;
+		}
+	}
+
+	template <typename field_type, typename decoded_type>
+	static void store(field_type &field, decoded_type value)
+	{
+		const auto integer = static_cast<integer_type>(value);
+		if constexpr (std::is_enum_v<field_type>) {
+			std::memcpy(&field, &integer, sizeof(integer));
+		} else {
+			field = integer;
+		}
+	}
+
+	static void check_range(reader &in, bool in_range)
+	{
+		if (!in_range) {
+			in.fail("integer too large");
+		}
+	}
+};
+
+/// Placeholder for all fields that are not static scalars (callbacks, arrays, oneofs, ...).
+struct unsupported_field {
+	static constexpr bool supported = false;
+};
+
+} // namespace detail
+
+/**
+ * @brief Straight-line encoder/decoder of a message with only scalar fields.
+ *
+ * The output is identical to the one of pb_encode() (fields in the order of the field list,
+ * proto3 fields with zero value omitted). decode() accepts and rejects the same input as
+ * pb_decode() without PB_DECODE_NULLTERMINATED and stores the same values: varints of 32 bit
+ * fields are truncated, keys and booleans are 32 bit varints, a zero tag is an error and unknown
+ * fields are skipped. As there is no descriptor to interpret, the code for every field is
+ * generated at compile time.
+ */
+template <typename message_type, typename... fields>
+struct scalar_codec {
+	static constexpr bool available = (fields::supported && ...);
+
+	static std::expected<std::span<uint8_t>, util::error_code>
+	encode(const message_type &message, std::span<uint8_t> buffer)
+	{
+		detail::writer out{buffer};
+		(fields::encode(message, out), ...);
+
+		if (out.failed()) {
+			return std::unexpected{error_code::encode_failure};
+		}
+		return buffer.first(static_cast<size_t>(out.current() - buffer.data()));
+	}
+
+	/**
+	 * @param reason Optional, set to why the decoding failed (see PB_GET_ERROR()).
+	 */
+	static util::error_code decode(std::span<const uint8_t> buffer, message_type &message,
+				       const char **reason = nullptr)
+	{
+		detail::reader in{buffer};
+		decode_fields(in, message, std::index_sequence_for<fields...>{});
+		if (in.failed()) {
+			if (reason != nullptr) {
+				*reason = in.error();
+			}
+			return error_code::decode_failure;
+		}
+		return {};
+	}
+
+private:
+	static_assert(sizeof...(fields) <= 64U, "the seen fields are tracked in a 64 bit mask");
+
+	template <size_t... indices>
+	static void decode_fields(detail::reader &in, message_type &message,
+				  std::index_sequence<indices...>)
+	{
+		constexpr uint64_t required_mask =
+			((fields::is_required ? (uint64_t{1} << indices) : 0U) | ... | 0U);
+
+		message = codec<message_type>::defaults;
+
+		uint64_t seen = 0U;
+		while (!in.empty() && !in.failed()) {
+			const auto key = in.varint32();
+			const auto number = key >> 3;
+			const auto type = static_cast<uint8_t>(key & 0x07U);
+			if (in.failed()) {
+				break;
+			}
+			if (number == 0U) {
+				in.fail("zero tag");
+				break;
+			}
+
+			const bool known =
+				((fields::decode(number, type, in, message) &&
+				  ((seen |= (uint64_t{1} << indices)), true)) ||
+				 ...);
+			if (!known) {
+				in.skip(type);
+			}
+		}
+
+		if ((seen & required_mask) != required_mask) {
+			in.fail("missing required field");
+		}
+	}
+};
+
+} // namespace protobuf
+
+// The nanopb field list calls X(struct, allocation, label, type, name, tag) for every field.
+// Only static singular and required fields can be scalars, everything else is not supported.
+#define PROTOBUF_SCALAR_CODEC_FIELD(message_name, allocation, label, type, name, tag)              \
+	, PROTOBUF_SCALAR_CODEC_##allocation##_##label(message_name, type, name, tag)
+
+#define PROTOBUF_SCALAR_CODEC_STATIC_SINGULAR(message_name, type, name, tag)                       \
+	protobuf::detail::scalar_field<&message_name::name, tag,                                   \
+				       PROTOBUF_SCALAR_CODEC_KIND_##type, false>
+#define PROTOBUF_SCALAR_CODEC_STATIC_REQUIRED(message_name, type, name, tag)                       \
+	protobuf::detail::scalar_field<&message_name::name, tag,                                   \
+				       PROTOBUF_SCALAR_CODEC_KIND_##type, true>
+#define PROTOBUF_SCALAR_CODEC_STATIC_OPTIONAL(...)  protobuf::detail::unsupported_field
+#define PROTOBUF_SCALAR_CODEC_STATIC_REPEATED(...)  protobuf::detail::unsupported_field
+#define PROTOBUF_SCALAR_CODEC_STATIC_FIXARRAY(...)  protobuf::detail::unsupported_field
+#define PROTOBUF_SCALAR_CODEC_STATIC_ONEOF(...)     protobuf::detail::unsupported_field
+#define PROTOBUF_SCALAR_CODEC_CALLBACK_SINGULAR(...) protobuf::detail::unsupported_field
+#define PROTOBUF_SCALAR_CODEC_CALLBACK_REQUIRED(...) protobuf::detail::unsupported_field
+#define PROTOBUF_SCALAR_CODEC_CALLBACK_OPTIONAL(...) protobuf::detail::unsupported_field
+#define PROTOBUF_SCALAR_CODEC_CALLBACK_REPEATED(...) protobuf::detail::unsupported_field
+#define PROTOBUF_SCALAR_CODEC_CALLBACK_ONEOF(...)   protobuf::detail::unsupported_field
+#define PROTOBUF_SCALAR_CODEC_POINTER_SINGULAR(...) protobuf::detail::unsupported_field
+#define PROTOBUF_SCALAR_CODEC_POINTER_REQUIRED(...) protobuf::detail::unsupported_field
+#define PROTOBUF_SCALAR_CODEC_POINTER_OPTIONAL(...) protobuf::detail::unsupported_field
+#define PROTOBUF_SCALAR_CODEC_POINTER_REPEATED(...) protobuf::detail::unsupported_field
+#define PROTOBUF_SCALAR_CODEC_POINTER_ONEOF(...)    protobuf::detail::unsupported_field
+
+#define PROTOBUF_SCALAR_CODEC_KIND_BOOL               protobuf::detail::scalar_kind::boolean
+#define PROTOBUF_SCALAR_CODEC_KIND_INT32              protobuf::detail::scalar_kind::int32
+#define PROTOBUF_SCALAR_CODEC_KIND_UINT32             protobuf::detail::scalar_kind::uint32
+#define PROTOBUF_SCALAR_CODEC_KIND_SINT32             protobuf::detail::scalar_kind::sint32
+#define PROTOBUF_SCALAR_CODEC_KIND_INT64              protobuf::detail::scalar_kind::int64
+#define PROTOBUF_SCALAR_CODEC_KIND_UINT64             protobuf::detail::scalar_kind::uint64
+#define PROTOBUF_SCALAR_CODEC_KIND_SINT64             protobuf::detail::scalar_kind::sint64
+#define PROTOBUF_SCALAR_CODEC_KIND_ENUM               protobuf::detail::scalar_kind::enumeration
+#define PROTOBUF_SCALAR_CODEC_KIND_UENUM                                                           \
+	protobuf::detail::scalar_kind::unsigned_enumeration
+#define PROTOBUF_SCALAR_CODEC_KIND_FIXED32            protobuf::detail::scalar_kind::fixed32
+#define PROTOBUF_SCALAR_CODEC_KIND_SFIXED32           protobuf::detail::scalar_kind::sfixed32
+#define PROTOBUF_SCALAR_CODEC_KIND_FLOAT              protobuf::detail::scalar_kind::float32
+#define PROTOBUF_SCALAR_CODEC_KIND_FIXED64            protobuf::detail::scalar_kind::fixed64
+#define PROTOBUF_SCALAR_CODEC_KIND_SFIXED64           protobuf::detail::scalar_kind::sfixed64
+#define PROTOBUF_SCALAR_CODEC_KIND_DOUBLE             protobuf::detail::scalar_kind::float64
+#define PROTOBUF_SCALAR_CODEC_KIND_BYTES              protobuf::detail::scalar_kind::unsupported
+#define PROTOBUF_SCALAR_CODEC_KIND_STRING             protobuf::detail::scalar_kind::unsupported
+#define PROTOBUF_SCALAR_CODEC_KIND_MESSAGE            protobuf::detail::scalar_kind::unsupported
+#define PROTOBUF_SCALAR_CODEC_KIND_MSG_W_CB           protobuf::detail::scalar_kind::unsupported
+#define PROTOBUF_SCALAR_CODEC_KIND_FIXED_LENGTH_BYTES protobuf::detail::scalar_kind::unsupported
+
+/**
+ * @brief Declares the codec of a message generated by nanopb from its field list.
+ *
+ * Must be used at global scope, once per message, in the header that wraps the generated header
+ * (*.pb.h) and that is included instead of it (like protobuf/storage_messages.hpp). If the
+ * message contains any field that is not a static scalar, the codec is not available and nanopb
+ * is used instead.
+ */
+#define PROTOBUF_SCALAR_CODEC(message_name)                                                        \
+	template <>                                                                                \
+	struct protobuf::codec<message_name>                                                       \
+		: protobuf::scalar_codec<message_name message_name##_FIELDLIST(                    \
+			  PROTOBUF_SCALAR_CODEC_FIELD, message_name)> {                            \
+		static constexpr message_name defaults = message_name##_init_default;              \
+	}
+
+/**
+ * @brief Declares that a message is encoded and decoded by nanopb (like PROTOBUF_SCALAR_CODEC).
+ */
+#define PROTOBUF_NANOPB_CODEC(message_name)                                                        \
+	template <>                                                                                \
+	struct protobuf::codec<message_name> {                                                     \
+		static constexpr bool available = false;                                           \
+	}
+
+#endif /* PROTOBUF_SCALAR_CODEC_HPP */
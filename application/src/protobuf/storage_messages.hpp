@@ -0,0 +1,11 @@
+#ifndef PROTOBUF_STORAGE_MESSAGES_HPP
+#define PROTOBUF_STORAGE_MESSAGES_HPP
+
+#include "protobuf/scalar_codec.hpp"
+#include "protobuf/storage.pb.h"
+
+// Codecs of the messages of storage.proto. protobuf::message needs them wherever a message is
+// used, so include this header instead of storage.pb.h.
+PROTOBUF_SCALAR_CODEC(RuntimeStatistics);
+
+#endif /* PROTOBUF_STORAGE_MESSAGES_HPP */
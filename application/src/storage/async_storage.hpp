@@ -0,0 +1,50 @@
+#ifndef STORAGE_ASYNC_STORAGE_HPP
+#define STORAGE_ASYNC_STORAGE_HPP
+
+#include "os/coroutine.hpp"
+#include "storage/non_volatile_storage.hpp"
+
+namespace storage
+{
+
+// Awaitable storage operations for os::task coroutines. The operations are executed on the
+// offload work queue, so that the coroutine work queue is not blocked while the flash is accessed.
+// The storage and the referenced messages must outlive the co_await.
+
+/**
+ * @brief Awaitable reading of a fixed data type (see basic_non_volatile_storage::read<T>).
+ */
+template <typename T, storage::backend backend_type>
+auto async_read(basic_non_volatile_storage<backend_type> &storage, uint16_t id)
+{
+	return os::offload{[&storage, id] { return storage.template read<T>(id); }};
+}
+
+/**
+ * @brief Awaitable writing of a fixed data type (see basic_non_volatile_storage::write<T>).
+ */
+template <typename T, storage::backend backend_type>
+auto async_write(basic_non_volatile_storage<backend_type> &storage, uint16_t id, const T &data)
+{
+	return os::offload{[&storage, id, data] { return storage.template write<T>(id, data); }};
+}
+
+#ifdef CONFIG_NANOPB
+template <storage::backend backend_type, typename type, size_t max_size>
+auto async_read(basic_non_volatile_storage<backend_type> &storage, uint16_t id,
+		protobuf::message<type, max_size> &message)
+{
+	return os::offload{[&storage, id, &message] { return storage.read(id, message); }};
+}
+
+template <storage::backend backend_type, typename type, size_t max_size>
+auto async_write(basic_non_volatile_storage<backend_type> &storage, uint16_t id,
+		 const protobuf::message<type, max_size> &message)
+{
+	return os::offload{[&storage, id, &message] { return storage.write(id, message); }};
+}
+#endif
+
+} // namespace storage
+
+#endif /* STORAGE_ASYNC_STORAGE_HPP */
@@ -0,0 +1,119 @@
+#ifndef STORAGE_BACKEND_HPP
+#define STORAGE_BACKEND_HPP
+
+#include "util/system_error.hpp"
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+
+namespace storage
+{
+
+/**
+ * @brief Requirements of a backend of the non-volatile storage.
+ *
+ * The backend is selected at compile time, so that the front-end (non_volatile_storage) can call
+ * it without virtual dispatch:
+ * - configure(): cheap preparation of the backend (e.g. checking the flash device)
+ * - mount(): bringing the stored records into a usable state (potentially slow)
+ * - clear(): removing all records
+ * - read(): copying a record into the buffer and returning the length of the stored record
+ * - write(): storing a record, where writing empty data deletes the record
+ */
+template <typename T>
+concept backend = requires(T backend, uint16_t id, std::span<uint8_t> buffer,
+			   std::span<const uint8_t> data) {
+	{ backend.configure() } -> std::same_as<util::error_code>;
+	{ backend.mount() } -> std::same_as<util::error_code>;
+	{ backend.clear() } -> std::same_as<util::error_code>;
+	{ backend.read(id, buffer) } -> std::same_as<std::expected<size_t, util::error_code>>;
+	{ backend.write(id, data) } -> std::same_as<util::error_code>;
+};
+
+/**
+ * @brief Backend that can give read-only access to records without copying them.
+ *
+ * map() returns a span that points directly into the (memory-mapped) storage. It stays valid
+ * until the next write to the backend.
+ */
+template <typename T>
+concept mappable_backend = backend<T> && requires(T backend, uint16_t id) {
+	{
+		backend.map(id)
+	} -> std::same_as<std::expected<std::span<const uint8_t>, util::error_code>>;
+};
+
+/**
+ * @brief Inclusive range of record IDs.
+ */
+struct id_range {
+	uint16_t first = 0U;
+	uint16_t last = UINT16_MAX;
+
+	[[nodiscard]] constexpr bool contains(uint16_t id) const
+	{
+		return (first <= id) && (id <= last);
+	}
+};
+
+/**
+ * @brief Stored record, as visited by the enumeration of a backend.
+ */
+struct record_entry {
+	uint16_t id;
+	size_t length;
+	/// The data directly in the storage, if the backend maps records (valid during the visit).
+	std::optional<std::span<const uint8_t>> data;
+};
+
+/// Next record of a sequence: the record, nothing after the last record, or an error.
+using next_record = std::expected<std::optional<record_entry>, util::error_code>;
+
+/**
+ * @brief Backend that can visit all stored records.
+ *
+ * for_each() calls the visitor as visitor(entry) once for every record with an ID in the range
+ * and stops as soon as the visitor returns false. The walk takes time proportional to the stored
+ * records, not to the range of IDs.
+ */
+template <typename T>
+concept enumerable_backend =
+	backend<T> && requires(T backend, id_range range, bool (*visitor)(const record_entry &)) {
+		{ backend.for_each(range, visitor) } -> std::same_as<util::error_code>;
+	};
+
+/**
+ * @brief Sectors of a backend on flash, which get erased as a whole.
+ */
+struct flash_geometry {
+	size_t sector_size;
+	size_t sector_count;
+};
+
+/**
+ * @brief Backend on flash that knows its sectors (e.g. for the wear accounting).
+ *
+ * geometry() is valid after configure().
+ */
+template <typename T>
+concept erasable_backend = backend<T> && requires(const T backend) {
+	{ backend.geometry() } -> std::same_as<flash_geometry>;
+};
+
+/**
+ * @brief Backend that replaces all of its records faster than by writing them one by one.
+ *
+ * restore() removes all records and writes the records that next() returns, until it returns
+ * no record or an error. The backend is mounted afterwards, also after an error.
+ */
+template <typename T>
+concept restorable_backend = backend<T> && requires(T backend, next_record (*next)()) {
+	{ backend.restore(next) } -> std::same_as<util::error_code>;
+};
+
+} // namespace storage
+
+#endif /* STORAGE_BACKEND_HPP */
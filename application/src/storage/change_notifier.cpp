@@ -0,0 +1,185 @@
+#include "change_notifier.hpp"
+#include <zephyr/logging/log.h>
+#include <algorithm>
+
+LOG_MODULE_REGISTER(change_notifier);
+
+namespace
+{
+K_THREAD_STACK_DEFINE(notification_stack, CONFIG_APP_STORAGE_NOTIFICATION_THREAD_STACK_SIZE);
+struct k_work_q notification_work_queue;
+
+int start_notification_work_queue()
+{
+	const struct k_work_queue_config config = {
+		.name = "storage_notify", .no_yield = false, .essential = false};
+
+	k_work_queue_init(&notification_work_queue);
+	k_work_queue_start(&notification_work_queue, notification_stack,
+			   K_THREAD_STACK_SIZEOF(notification_stack),
+			   CONFIG_APP_STORAGE_NOTIFICATION_THREAD_PRIORITY, &config);
+	return 0;
+}
+
+SYS_INIT(start_notification_work_queue, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+} // namespace
+
+namespace storage
+{
+
+change_notifier::change_notifier()
+{
+	k_mutex_init(&lock);
+	k_msgq_init(&queue, reinterpret_cast<char *>(queue_buffer.data()), sizeof(change),
+		    queue_buffer.size());
+	work.notifier = this;
+	k_work_init(&work.work, dispatch_handler);
+}
+
+change_notifier::~change_notifier()
+{
+	// the dispatch must not access the notifier anymore after its destruction
+	struct k_work_sync sync;
+	k_work_cancel_sync(&work.work, &sync);
+}
+
+std::expected<subscription_id, util::error_code>
+change_notifier::subscribe(uint16_t first, uint16_t last, change_callback callback,
+			   const void *owner)
+{
+	if (first > last || !callback) {
+		return std::unexpected{util::errc::invalid_argument};
+	}
+
+	k_mutex_lock(&lock, K_FOREVER);
+	const auto position =
+		std::ranges::upper_bound(subscriptions, first, {}, &subscription::first);
+	const auto id = next_id;
+
+	const auto inserted = subscriptions.insert(
+		position, subscription{first, last, last, id, owner, std::move(callback)});
+	if (inserted != subscriptions.end()) {
+		++next_id;
+		(void)update_reach(0U, subscriptions.size());
+	}
+	k_mutex_unlock(&lock);
+
+	if (inserted == subscriptions.end()) {
+		LOG_WRN("No subscription left for the IDs %u to %u.", first, last);
+		return std::unexpected{util::errc::not_enough_memory};
+	}
+	return id;
+}
+
+void change_notifier::unsubscribe(subscription_id id)
+{
+	k_mutex_lock(&lock, K_FOREVER);
+	const auto position = std::ranges::find(subscriptions, id, &subscription::id);
+	if (position != subscriptions.end()) {
+		subscriptions.erase(position);
+		(void)update_reach(0U, subscriptions.size());
+	}
+	k_mutex_unlock(&lock);
+}
+
+void change_notifier::unsubscribe_all(const void *owner)
+{
+	k_mutex_lock(&lock, K_FOREVER);
+	for (auto position = subscriptions.begin(); position != subscriptions.end();) {
+		if (position->owner == owner) {
+			position = subscriptions.erase(position);
+		} else {
+			++position;
+		}
+	}
+	(void)update_reach(0U, subscriptions.size());
+	k_mutex_unlock(&lock);
+
+	// a dispatch may have copied the callbacks before they got removed
+	struct k_work_sync sync;
+	k_work_flush(&work.work, &sync);
+}
+
+void change_notifier::publish(change change)
+{
+	if (k_msgq_put(&queue, &change, K_NO_WAIT) != 0) {
+		// the subscribers get informed once, instead of the dropped changes
+		atomic_set(&lost, 1);
+	}
+	k_work_submit_to_queue(&notification_work_queue, &work.work);
+}
+
+void change_notifier::dispatch_handler(struct k_work *work)
+{
+	auto *const notifier = CONTAINER_OF(work, dispatch_work, work)->notifier;
+
+	change next;
+	while (k_msgq_get(&notifier->queue, &next, K_NO_WAIT) == 0) {
+		notifier->dispatch(next);
+	}
+
+	if (atomic_clear(&notifier->lost) != 0) {
+		LOG_WRN("%s", "Storage changes were dropped, as the notification queue was full.");
+		notifier->dispatch({0U, change_kind::lost});
+	}
+}
+
+void change_notifier::dispatch(change change)
+{
+	// the callbacks are executed without holding the lock, so that they can unsubscribe
+	callback_list callbacks;
+	k_mutex_lock(&lock, K_FOREVER);
+
+	if (change.kind == change_kind::cleared || change.kind == change_kind::lost) {
+		for (const auto &entry : subscriptions) {
+			callbacks.push_back(entry.callback);
+		}
+	} else {
+		collect(0U, subscriptions.size(), change.id, callbacks);
+	}
+
+	k_mutex_unlock(&lock);
+
+	for (const auto &callback : callbacks) {
+		callback(change);
+	}
+}
+
+uint16_t change_notifier::update_reach(size_t begin, size_t end)
+{
+	if (begin >= end) {
+		return 0U;
+	}
+
+	const auto index = begin + (end - begin) / 2U;
+	auto &root = subscriptions[index];
+	root.reach =
+		std::max({root.last, update_reach(begin, index), update_reach(index + 1U, end)});
+	return root.reach;
+}
+
+void change_notifier::collect(size_t begin, size_t end, uint16_t id,
+			      callback_list &callbacks) const
+{
+	while (begin < end) {
+		const auto index = begin + (end - begin) / 2U;
+		const auto &root = subscriptions[index];
+		if (root.reach < id) {
+			// no range of the subtree reaches the ID
+			return;
+		}
+
+		collect(begin, index, id, callbacks);
+		if (root.first > id) {
+			// the root and its right subtree start above the ID
+			return;
+		}
+		if (root.last >= id) {
+			callbacks.push_back(root.callback);
+		}
+		begin = index + 1U;
+	}
+}
+
+} // namespace storage
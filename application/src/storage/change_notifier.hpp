@@ -0,0 +1,130 @@
+#ifndef STORAGE_CHANGE_NOTIFIER_HPP
+#define STORAGE_CHANGE_NOTIFIER_HPP
+
+#include <zephyr/kernel.h>
+#include "util/inplace_function.hpp"
+#include "util/static_vector.hpp"
+#include "util/system_error.hpp"
+#include <array>
+#include <cstdint>
+#include <expected>
+
+namespace storage
+{
+
+enum class change_kind : uint8_t {
+	written, ///< The record got new data.
+	deleted, ///< The record was deleted (written with empty data).
+	cleared, ///< The whole storage was cleared (the ID is not used).
+	lost,    ///< Changes were dropped, as the queue was full: all records need to be re-read.
+};
+
+/**
+ * @brief Change of a record, as passed to the subscribers.
+ *
+ * The data itself is not part of the notification. The subscribers read it (or get a view of it)
+ * from the storage, only if they need it.
+ */
+struct change {
+	uint16_t id;
+	change_kind kind;
+
+	friend bool operator==(const change &, const change &) = default;
+};
+
+using change_callback = util::inplace_function<void(const change &)>;
+using subscription_id = uint16_t;
+
+/**
+ * @brief Notifies subscribers of record IDs or ID ranges about changes of the storage.
+ *
+ * The changes are published by the writers into a message queue (without blocking) and
+ * dispatched to the matching subscribers on the notification work queue. The subscriptions are
+ * sorted by the first ID of their range and form an implicit balanced search tree (the middle of
+ * every index range is its root), in which every node keeps the largest last ID of its subtree.
+ * The dispatch thereby skips whole subtrees that start above or end below the ID, so that it
+ * visits the matching subscriptions and at most a logarithmic number of others per match.
+ */
+class change_notifier
+{
+public:
+	change_notifier();
+	~change_notifier();
+
+	// the notifier is referenced by its work item and can hence not be copied or moved
+	change_notifier(const change_notifier &) = delete;
+	change_notifier &operator=(const change_notifier &) = delete;
+
+	/**
+	 * @brief Subscribes to the changes of the records from the first to the last ID.
+	 *
+	 * The callback is executed on the notification work queue. It may read the storage and
+	 * subscribe or unsubscribe, but it must not write to the storage. The subscriptions of an
+	 * owner can be removed all at once with unsubscribe_all().
+	 *
+	 * @return The ID of the subscription for unsubscribing or an error, if there are already
+	 *         CONFIG_APP_STORAGE_MAX_SUBSCRIPTIONS subscriptions.
+	 */
+	[[nodiscard]] std::expected<subscription_id, util::error_code>
+	subscribe(uint16_t first, uint16_t last, change_callback callback,
+		  const void *owner = nullptr);
+
+	/**
+	 * @brief Removes the subscription. Notifications that are already dispatched may still be
+	 *        running.
+	 */
+	void unsubscribe(subscription_id id);
+
+	/**
+	 * @brief Removes all subscriptions of the owner and waits for a running dispatch, so that
+	 *        none of their callbacks gets called anymore after the return.
+	 *
+	 * Must not be called from a notification callback.
+	 */
+	void unsubscribe_all(const void *owner);
+
+	/**
+	 * @brief Queues the change for the subscribers (can be called from any thread).
+	 */
+	void publish(change change);
+
+private:
+	static void dispatch_handler(struct k_work *work);
+	void dispatch(change change);
+
+	struct subscription {
+		uint16_t first;
+		uint16_t last;
+		uint16_t reach; ///< largest last ID of the subtree with this subscription as root
+		subscription_id id;
+		const void *owner;
+		change_callback callback;
+	};
+
+	using subscription_list =
+		util::static_vector<subscription, CONFIG_APP_STORAGE_MAX_SUBSCRIPTIONS>;
+	using callback_list =
+		util::static_vector<change_callback, CONFIG_APP_STORAGE_MAX_SUBSCRIPTIONS>;
+
+	uint16_t update_reach(size_t begin, size_t end);
+	void collect(size_t begin, size_t end, uint16_t id, callback_list &callbacks) const;
+
+	/// Work item of the dispatch (kept standard-layout to get back to the notifier).
+	struct dispatch_work {
+		struct k_work work;
+		change_notifier *notifier;
+	};
+
+	subscription_list subscriptions{};
+	subscription_id next_id = 0U;
+	struct k_mutex lock;
+
+	std::array<change, CONFIG_APP_STORAGE_NOTIFICATION_QUEUE_SIZE> queue_buffer;
+	struct k_msgq queue;
+	atomic_t lost = ATOMIC_INIT(0);
+	dispatch_work work{};
+};
+
+} // namespace storage
+
+#endif /* STORAGE_CHANGE_NOTIFIER_HPP */
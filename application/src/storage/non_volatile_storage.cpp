@@ -1,76 +1,84 @@
 #include "non_volatile_storage.hpp"
-#include <zephyr/drivers/flash.h>
-#include <zephyr/fs/nvs.h>
 #include <zephyr/logging/log.h>
-#include <zephyr/storage/flash_map.h>
 
 LOG_MODULE_REGISTER(non_volatile_storage);
 
-// definition of the flash partition to be used for the storage
-#define NVS_PARTITION        storage_partition
-#define NVS_PARTITION_DEVICE FIXED_PARTITION_DEVICE(NVS_PARTITION)
-#define NVS_PARTITION_OFFSET FIXED_PARTITION_OFFSET(NVS_PARTITION)
-
+#ifdef CONFIG_APP_STORAGE_LAZY_MOUNT
 namespace
 {
-struct error_category : public util::error_category {
-	[[nodiscard]] const char *name() const noexcept override
-	{
-		return "non_volatile_storage";
-	}
-
-	[[nodiscard]] const char *message(int ev) const noexcept override
-	{
-		switch (static_cast<storage_error_code>(ev)) {
-		case storage_error_code::device_not_ready:
-			return "Device is not ready";
-		case storage_error_code::unable_to_get_page_info:
-			return "Unable to get page info";
-		case storage_error_code::wrong_data_size:
-			return "Wrong data size";
-		}
-
-		return "Unknown error";
-	}
-};
-
-const error_category the_error_category{};
+constexpr uint32_t mount_done_event = BIT(0);
+
+K_THREAD_STACK_DEFINE(mount_thread_stack, CONFIG_APP_STORAGE_MOUNT_THREAD_STACK_SIZE);
+struct k_work_q mount_work_queue;
+
+int start_mount_work_queue()
+{
+	const struct k_work_queue_config config = {
+		.name = "storage_mount", .no_yield = false, .essential = false};
+
+	k_work_queue_init(&mount_work_queue);
+	k_work_queue_start(&mount_work_queue, mount_thread_stack,
+			   K_THREAD_STACK_SIZEOF(mount_thread_stack),
+			   CONFIG_APP_STORAGE_MOUNT_THREAD_PRIORITY, &config);
+	return 0;
+}
+
+SYS_INIT(start_mount_work_queue, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
 
 } // namespace
 
-util::error_code make_error_code(storage_error_code code)
+namespace storage
+{
+
+mount_runner::mount_runner()
 {
-	return {static_cast<int>(code), the_error_category};
+	background_mount.runner = this;
+	k_work_init(&background_mount.work, mount_handler);
+
+	// as long as no mount was started, there is no mount to wait for
+	k_event_init(&mount_done);
+	k_event_post(&mount_done, mount_done_event);
 }
 
-util::error_code non_volatile_storage::init()
+mount_runner::~mount_runner()
 {
-	/* define the nvs file system by settings with:
-	 *	sector_size equal to the pagesize,
-	 *	2 sectors
-	 *	starting at NVS_PARTITION_OFFSET
-	 */
-	fs.flash_device = NVS_PARTITION_DEVICE;
-	if (!device_is_ready(fs.flash_device)) {
-		LOG_ERR("Flash device %s is not ready.", fs.flash_device->name);
-		return storage_error_code::device_not_ready;
-	}
-
-	fs.offset = NVS_PARTITION_OFFSET;
-	struct flash_pages_info info;
-	auto rc = flash_get_page_info_by_offs(fs.flash_device, fs.offset, &info);
-	if (rc) {
-		LOG_ERR("%s", "Unable to get page info.");
-		return storage_error_code::unable_to_get_page_info;
-	}
-	fs.sector_size = info.size;
-	fs.sector_count = 2U;
-
-	rc = nvs_mount(&fs);
-	if (rc < 0) {
-		LOG_ERR("%s", "Flash Init failed.");
-		return os::result_to_error_code(rc);
-	}
+	// the background mount must not access the backend anymore after its destruction
+	struct k_work_sync sync;
+	k_work_flush(&background_mount.work, &sync);
+}
 
+util::error_code mount_runner::start(mount_function mount, void *backend)
+{
+	// scanning the partition happens on the mount thread, while the storage operations wait for
+	// the mount_done event
+	this->mount = mount;
+	this->backend = backend;
+	k_event_clear(&mount_done, mount_done_event);
+	k_work_submit_to_queue(&mount_work_queue, &background_mount.work);
 	return {};
 }
+
+util::error_code mount_runner::wait()
+{
+	k_event_wait(&mount_done, mount_done_event, false, K_FOREVER);
+	return mount_result;
+}
+
+void mount_runner::mount_handler(struct k_work *work)
+{
+	auto *const job = CONTAINER_OF(work, mount_work, work);
+	auto *const runner = job->runner;
+
+	runner->mount_result = runner->mount(runner->backend);
+	k_event_post(&runner->mount_done, mount_done_event);
+}
+
+} // namespace storage
+#endif
+
+non_volatile_storage &shared_storage()
+{
+	// constructed on the first use, as it is used by the initialization of other modules
+	static non_volatile_storage storage{};
+	return storage;
+}
@@ -1,45 +1,189 @@
 #ifndef STORAGE_NON_VOLATILE_STORAGE_HPP
 #define STORAGE_NON_VOLATILE_STORAGE_HPP
 
-#include <zephyr/fs/nvs.h>
+#include <zephyr/kernel.h>
 #include "os/kernel.hpp"
+#include "storage/backend.hpp"
+#include "storage/ram_backend.hpp"
+#include "storage/record_view.hpp"
+#include "storage/storage_error.hpp"
+#include <array>
 #include <expected>
 #include <span>
+#include <type_traits>
+#include <utility>
+
+#ifdef CONFIG_NVS
+#include "storage/nvs_backend.hpp"
+#endif
 
 #ifdef CONFIG_NANOPB
 #include "protobuf/protobuf_message.hpp"
 #endif
 
-enum class storage_error_code : uint8_t {
-	device_not_ready = 1,
-	unable_to_get_page_info = 2,
-	wrong_data_size = 3,
-};
+#ifdef CONFIG_APP_STORAGE_RECORD_CRC
+#include "storage/record_crc.hpp"
+#include <algorithm>
+#endif
+
+#ifdef CONFIG_APP_STORAGE_NOTIFICATIONS
+#include "storage/change_notifier.hpp"
+#endif
+
+#ifdef CONFIG_APP_STORAGE_WEAR_GOVERNOR
+#include "storage/wear_governor.hpp"
+#include <algorithm>
+#endif
 
-util::error_code make_error_code(storage_error_code code);
+#ifdef CONFIG_APP_STORAGE_SNAPSHOT
+#include "storage/snapshot.hpp"
+#endif
 
-// the concrete error code type needs to be made known to the 'system_error'
-// implementation that resides in the 'util' namespace
-namespace util
+namespace storage
 {
-template <>
-struct is_error_code_enum<storage_error_code> : public std::true_type {
+
+#if defined(CONFIG_APP_STORAGE_BACKEND_RAM)
+using default_backend = ram_backend;
+#else
+using default_backend = nvs_backend;
+#endif
+
+/**
+ * @brief Runs the mount of a storage backend, either directly or on a background thread.
+ *
+ * With CONFIG_APP_STORAGE_LAZY_MOUNT, the mount is executed on a dedicated work queue and the
+ * storage operations wait for its completion. Without it, the mount is executed directly.
+ */
+class mount_runner
+{
+public:
+	using mount_function = util::error_code (*)(void *backend);
+
+#ifdef CONFIG_APP_STORAGE_LAZY_MOUNT
+	mount_runner();
+	~mount_runner();
+
+	/**
+	 * @brief Starts the mount on the mount thread.
+	 *
+	 * @return Always no error, as the result of the mount is returned by wait().
+	 */
+	util::error_code start(mount_function mount, void *backend);
+
+	/**
+	 * @brief Blocks until a mount running in the background has completed.
+	 *
+	 * @return The result of the mount.
+	 */
+	util::error_code wait();
+#else
+	mount_runner() = default;
+
+	util::error_code start(mount_function mount, void *backend)
+	{
+		return mount(backend);
+	}
+
+	util::error_code wait()
+	{
+		return {};
+	}
+#endif
+
+	// the runner is referenced by the background mount and can hence not be copied or moved
+	mount_runner(const mount_runner &) = delete;
+	mount_runner &operator=(const mount_runner &) = delete;
+
+#ifdef CONFIG_APP_STORAGE_LAZY_MOUNT
+private:
+	static void mount_handler(struct k_work *work);
+
+	/// Work item of the background mount (kept standard-layout to get back to the runner).
+	struct mount_work {
+		struct k_work work;
+		mount_runner *runner;
+	};
+
+	mount_work background_mount{};
+	struct k_event mount_done; ///< Gets posted as soon as no mount is running anymore.
+	mount_function mount = nullptr;
+	void *backend = nullptr;
+	util::error_code mount_result{};
+#endif
 };
-} // namespace util
+
+} // namespace storage
 
 /**
  * @brief Non-volatile storage that can store fixed data types (templated), binary buffers and
- *        protobuf message via the 'nvs' module of Zephyr.
+ *        protobuf message via a backend that is selected at compile time (see storage::backend).
  */
-class non_volatile_storage
+template <storage::backend backend_type>
+class basic_non_volatile_storage
 {
 public:
-	[[nodiscard]] util::error_code init();
+	basic_non_volatile_storage() = default;
+
+#ifdef CONFIG_APP_STORAGE_NOTIFICATIONS
+	~basic_non_volatile_storage()
+	{
+		// the notifier may be shared and outlive the instance, its subscriptions may not
+		notifier.unsubscribe_all(this);
+	}
+#endif
+
+	// the backend is referenced by the background mount and can hence not be copied
+	basic_non_volatile_storage(const basic_non_volatile_storage &) = delete;
+	basic_non_volatile_storage &operator=(const basic_non_volatile_storage &) = delete;
+
+	/**
+	 * @brief Mounts the storage backend.
+	 *
+	 * With CONFIG_APP_STORAGE_LAZY_MOUNT, the mount itself is only started on a background
+	 * thread and the function returns immediately. The storage operations then wait for the
+	 * mount to complete and return its error, if it failed.
+	 */
+	[[nodiscard]] util::error_code init()
+	{
+		const os::profiling::scoped_timer timer{"non_volatile_storage::init"};
+
+		// a previous background mount must have finished before reconfiguring the backend
+		(void)mounting.wait();
+
+		if (const auto error = backend.configure()) {
+			return error;
+		}
+
+		const auto error = mounting.start(
+			[](void *backend) { return static_cast<backend_type *>(backend)->mount(); },
+			&backend);
+#ifdef CONFIG_APP_STORAGE_WEAR_GOVERNOR
+		if (!error) {
+			start_governor();
+		}
+#endif
+		return error;
+	}
 
 	[[nodiscard]] util::error_code clear()
 	{
-		const auto result = nvs_clear(&fs);
-		return os::result_to_error_code(result);
+		if (const auto error = mounting.wait()) {
+			return error;
+		}
+
+#ifdef CONFIG_APP_STORAGE_WEAR_GOVERNOR
+		// waits for a deferred write that is being written, so that it does not outlive the
+		// clear (not with the pin lock held, as the governor takes it for writing)
+		governor.discard();
+#endif
+		const storage::exclusive_pin_lock lock{pins};
+		const auto error = backend.clear();
+#ifdef CONFIG_APP_STORAGE_NOTIFICATIONS
+		if (!error) {
+			notifier.publish({0U, storage::change_kind::cleared});
+		}
+#endif
+		return error;
 	}
 
 	/**
@@ -50,13 +194,13 @@ public:
 	{
 		T data{};
 
-		const auto result = nvs_read(&fs, id, &data, sizeof(data));
-		const auto error = os::result_to_error_code(result);
-		if (error) {
-			return std::unexpected{error};
+		const auto result = read(id, std::span<uint8_t>{reinterpret_cast<uint8_t *>(&data),
+								 sizeof(data)});
+		if (!result) {
+			return std::unexpected{result.error()};
 		}
 
-		if (result != sizeof(data)) {
+		if (result->size() != sizeof(data)) {
 			return std::unexpected{storage_error_code::wrong_data_size};
 		}
 
@@ -69,15 +213,120 @@ public:
 	[[nodiscard]] std::expected<std::span<uint8_t>, util::error_code>
 	read(uint16_t id, std::span<uint8_t> buffer)
 	{
-		const auto result = nvs_read(&fs, id, buffer.data(), buffer.size());
-		const auto error = os::result_to_error_code(result);
-		if (error) {
+		if (const auto error = mounting.wait()) {
 			return std::unexpected{error};
 		}
 
-		// if the result was not an error (was not < 0), then it indicates the read length
-		// (which is >= 0)
-		return std::span<uint8_t>{buffer.data(), static_cast<size_t>(result)};
+		const os::profiling::scoped_timer timer{"storage read"};
+#ifdef CONFIG_APP_STORAGE_WEAR_GOVERNOR
+		// a deferred write is newer than the stored record
+		if (auto deferred = governor.read_deferred(id, buffer)) {
+			return std::move(*deferred);
+		}
+#endif
+#ifdef CONFIG_APP_STORAGE_RECORD_CRC
+		// the record is verified before it gets copied into the buffer of the caller
+		if constexpr (storage::mappable_backend<backend_type>) {
+			const auto record = view(id);
+			if (!record) {
+				return std::unexpected{record.error()};
+			}
+			return copy_to(record->data(), buffer);
+		} else {
+			std::array<uint8_t, max_record_size> record_buffer;
+			const auto length = backend.read(id, record_buffer);
+			if (!length) {
+				return std::unexpected{length.error()};
+			}
+
+			if (length.value() > record_buffer.size()) {
+				return std::unexpected{storage_error_code::wrong_data_size};
+			}
+
+			const auto data = storage::record_crc::verify(
+				std::span<const uint8_t>{record_buffer}.first(length.value()));
+			if (!data) {
+				return std::unexpected{data.error()};
+			}
+			return copy_to(data.value(), buffer);
+		}
+#else
+		const auto length = backend.read(id, buffer);
+		if (!length) {
+			return std::unexpected{length.error()};
+		}
+
+		// the stored record does not fit into the buffer
+		if (length.value() > buffer.size()) {
+			return std::unexpected{storage_error_code::wrong_data_size};
+		}
+
+		return buffer.first(length.value());
+#endif
+	}
+
+	/**
+	 * @brief Read-only access to a stored record without copying it (if the backend allows).
+	 *
+	 * For backends that can map records (storage::mappable_backend), the view points directly
+	 * into the storage and pins the record: writes wait until all views were destroyed, so that
+	 * the record can not be relocated (e.g. by the garbage collection of nvs). Other backends
+	 * copy the record into the fallback buffer instead.
+	 *
+	 * @param id The ID of the record.
+	 * @param fallback_buffer Buffer for the record, if it cannot be accessed without a copy.
+	 */
+	[[nodiscard]] std::expected<storage::record_view, util::error_code>
+	view(uint16_t id, std::span<uint8_t> fallback_buffer = {})
+	{
+		if constexpr (storage::mappable_backend<backend_type>) {
+			if (const auto error = mounting.wait()) {
+				return std::unexpected{error};
+			}
+
+			const os::profiling::scoped_timer timer{"storage view"};
+#ifdef CONFIG_APP_STORAGE_WEAR_GOVERNOR
+			// a deferred write is copied into the fallback buffer or, if it does not
+			// fit, written to the flash now, as far as it is within its budget
+			if (auto deferred = governor.read_deferred(id, fallback_buffer)) {
+				if (deferred->has_value()) {
+					return storage::record_view{deferred->value(), nullptr};
+				}
+				if (deferred->error() != storage_error_code::wrong_data_size) {
+					return std::unexpected{deferred->error()};
+				}
+				const auto flushed = governor.flush(id);
+				if (!flushed) {
+					return std::unexpected{flushed.error()};
+				}
+				if (!flushed.value()) {
+					return std::unexpected{deferred->error()};
+				}
+			}
+#endif
+			pins.pin();
+			const auto data = backend.map(id);
+			if (!data) {
+				pins.unpin();
+				return std::unexpected{data.error()};
+			}
+#ifdef CONFIG_APP_STORAGE_RECORD_CRC
+			const auto verified = storage::record_crc::verify(data.value());
+			if (!verified) {
+				pins.unpin();
+				return std::unexpected{verified.error()};
+			}
+			return storage::record_view{verified.value(), &pins};
+#else
+			return storage::record_view{data.value(), &pins};
+#endif
+		} else {
+			const auto data = read(id, fallback_buffer);
+			if (!data) {
+				return std::unexpected{data.error()};
+			}
+			return storage::record_view{data.value(), nullptr};
+		}
 	}
 
 	/**
@@ -86,32 +335,276 @@ public:
 	template <typename T>
 	[[nodiscard]] util::error_code write(uint16_t id, T const &data)
 	{
-		const auto result = nvs_write(&fs, id, &data, sizeof(data));
-		return os::result_to_error_code(result);
+		return write(id, std::span<const uint8_t>{reinterpret_cast<const uint8_t *>(&data),
+							  sizeof(data)});
 	}
 
 	/**
 	 * @brief Writing of data from a provided buffer into the storage.
 	 */
+	[[nodiscard]] util::error_code write(uint16_t id, std::span<const uint8_t> buffer)
+	{
+#ifdef CONFIG_APP_STORAGE_WEAR_GOVERNOR
+		if (const auto error = mounting.wait()) {
+			return error;
+		}
+
+		// writes over the budget are taken by the governor and written in a later interval
+		const auto error = governor.write(id, buffer);
+#else
+		const auto error = write_record(id, buffer);
+#endif
+#ifdef CONFIG_APP_STORAGE_NOTIFICATIONS
+		if (!error) {
+			notifier.publish({id, buffer.empty() ? storage::change_kind::deleted
+							     : storage::change_kind::written});
+		}
+#endif
+		return error;
+	}
+
 	[[nodiscard]] util::error_code write(uint16_t id, std::span<uint8_t> buffer)
 	{
-		const auto result = nvs_write(&fs, id, buffer.data(), buffer.size());
-		return os::result_to_error_code(result);
+		return write(id, std::span<const uint8_t>{buffer});
+	}
+
+	/**
+	 * @brief Visits every stored record with an ID in the range once, in no particular order.
+	 *
+	 * The visitor gets called as visitor(entry) with a storage::record_entry and returns false
+	 * to stop the walk. The walk is a single pass over the records of the backend (e.g. over
+	 * the allocation table of nvs), so it takes time proportional to the stored records and not
+	 * to the range of IDs.
+	 *
+	 * If the backend can map records, the entry gives the data of the record (without its CRC)
+	 * for the duration of the visit. Records that fail the CRC verification and records of
+	 * other backends are visited without data: the visitor reads them, if it needs them.
+	 *
+	 * Writes wait until the walk is completed. The visitor may read the storage, but it must
+	 * not write to it.
+	 */
+	template <typename visitor_type>
+		requires storage::enumerable_backend<backend_type>
+	[[nodiscard]] util::error_code for_each(storage::id_range range, visitor_type &&visitor)
+	{
+		if (const auto error = mounting.wait()) {
+			return error;
+		}
+#ifdef CONFIG_APP_STORAGE_WEAR_GOVERNOR
+		// the deferred writes are written first, so that the walk sees them
+		if (const auto error = governor.flush()) {
+			return error;
+		}
+#endif
+
+		const storage::exclusive_pin_lock lock{pins};
+		return backend.for_each(range, [&visitor](storage::record_entry entry) {
+#ifdef CONFIG_APP_STORAGE_RECORD_CRC
+			entry.length -= std::min(entry.length, storage::record_crc::size);
+			if (entry.data) {
+				const auto verified = storage::record_crc::verify(*entry.data);
+				entry.data =
+					verified ? std::optional{verified.value()} : std::nullopt;
+			}
+#endif
+			return visitor(std::as_const(entry));
+		});
+	}
+
+	/**
+	 * @brief Visits the ID of every stored record in the range once, in no particular order.
+	 *
+	 * Like for_each(), but without the data of the records and without verifying their CRC,
+	 * for callers that only list the records and read them afterwards (e.g. the scrubber).
+	 * Writes that the wear governor deferred are not written first, so that their records are
+	 * only visited if they were stored before.
+	 *
+	 * @param visitor Gets called as visitor(id) and returns false to stop the walk.
+	 */
+	template <typename visitor_type>
+		requires storage::enumerable_backend<backend_type>
+	[[nodiscard]] util::error_code for_each_id(storage::id_range range, visitor_type &&visitor)
+	{
+		if (const auto error = mounting.wait()) {
+			return error;
+		}
+
+		const storage::exclusive_pin_lock lock{pins};
+		return backend.for_each(range, [&visitor](const storage::record_entry &entry) {
+			return visitor(entry.id);
+		});
+	}
+
+	/**
+	 * @brief Visits every stored record once (see the overload with an ID range).
+	 */
+	template <typename visitor_type>
+		requires storage::enumerable_backend<backend_type>
+	[[nodiscard]] util::error_code for_each(visitor_type &&visitor)
+	{
+		return for_each(storage::id_range{}, std::forward<visitor_type>(visitor));
+	}
+
+#ifdef CONFIG_APP_STORAGE_SNAPSHOT
+	/**
+	 * @brief Streams a snapshot of all records into the sink (see storage::snapshot).
+	 *
+	 * The records are taken in a single walk over the storage, so writes wait until the export
+	 * is completed. Records that the backend can not map are read into the buffer, which then
+	 * needs to fit the largest record.
+	 */
+	[[nodiscard]] util::error_code export_snapshot(storage::snapshot::sink sink,
+						       std::span<uint8_t> buffer = {})
+		requires storage::enumerable_backend<backend_type>
+	{
+		storage::snapshot::encoder encoder{std::move(sink)};
+		if (const auto error = encoder.begin()) {
+			return error;
+		}
+
+		util::error_code error{};
+		const auto walked = for_each([&](const storage::record_entry &entry) {
+			auto data = entry.data;
+			if (!data) {
+				const auto record = read(entry.id, buffer);
+				if (!record) {
+					error = record.error();
+					return false;
+				}
+				data = record.value();
+			}
+
+			error = encoder.add(entry.id, *data);
+			return !error;
+		});
+		if (walked) {
+			return walked;
+		}
+		if (error) {
+			return error;
+		}
+
+		return encoder.finish();
+	}
+
+	/**
+	 * @brief Replaces all records by the records of a snapshot.
+	 *
+	 * The whole snapshot is read and verified first (storage::snapshot::verify()), so that an
+	 * invalid, truncated or corrupted snapshot leaves the records untouched. Only then are the
+	 * records replaced: backends that can write them sequentially (storage::restorable_backend)
+	 * do so, the others are cleared and get the records written one by one. A source that
+	 * returns other data in the second read fails it, after the records before the difference
+	 * were restored.
+	 *
+	 * Deferred writes of the wear governor are dropped and the restore is not accounted by it.
+	 *
+	 * @param buffer Buffer for the data of a single record. With CONFIG_APP_STORAGE_RECORD_CRC,
+	 *               at most CONFIG_APP_STORAGE_RECORD_CRC_MAX_SIZE bytes of it are used, so
+	 *               that larger records fail the verification with no_buffer_space.
+	 */
+	[[nodiscard]] util::error_code restore_snapshot(const storage::snapshot::source &source,
+							std::span<uint8_t> buffer)
+	{
+		if (const auto error = mounting.wait()) {
+			return error;
+		}
+#ifdef CONFIG_APP_STORAGE_RECORD_CRC
+		buffer = buffer.first(
+			std::min<size_t>(buffer.size(), CONFIG_APP_STORAGE_RECORD_CRC_MAX_SIZE));
+#endif
+		if (const auto error = storage::snapshot::verify(source, buffer)) {
+			return error;
+		}
+
+#ifdef CONFIG_APP_STORAGE_WEAR_GOVERNOR
+		governor.discard();
+#endif
+		storage::snapshot::decoder decoder{source, buffer};
+		const auto error = restore_records(decoder);
+#ifdef CONFIG_APP_STORAGE_NOTIFICATIONS
+		// all records may have changed, also if the restore failed
+		notifier.publish({0U, storage::change_kind::lost});
+#endif
+		return error;
+	}
+#endif
+
+#ifdef CONFIG_APP_STORAGE_NOTIFICATIONS
+	/**
+	 * @brief Subscribes to the changes of the records from the first to the last ID.
+	 *
+	 * The callback gets called on the notification work queue after every successful write or
+	 * clear (see storage::change_notifier), so that the subscribers do not need to poll. The
+	 * flash backends store all records on the storage partition, so that the instances with the
+	 * same backend type share their notifier: writes through any of them are notified to the
+	 * subscribers of all of them. The records of the RAM backend and thereby its notifier
+	 * belong to the instance. The subscriptions are removed with the instance they were made
+	 * through.
+	 */
+	[[nodiscard]] std::expected<storage::subscription_id, util::error_code>
+	subscribe(uint16_t first, uint16_t last, storage::change_callback callback)
+	{
+		return notifier.subscribe(first, last, std::move(callback), this);
+	}
+
+	[[nodiscard]] std::expected<storage::subscription_id, util::error_code>
+	subscribe(uint16_t id, storage::change_callback callback)
+	{
+		return notifier.subscribe(id, id, std::move(callback), this);
 	}
 
+	void unsubscribe(storage::subscription_id id)
+	{
+		notifier.unsubscribe(id);
+	}
+#endif
+
+#ifdef CONFIG_APP_STORAGE_WEAR_GOVERNOR
+	/**
+	 * @brief Accounting and budgets of the flash wear (see storage::wear_governor).
+	 */
+	[[nodiscard]] const storage::wear_governor &wear() const
+	{
+		return governor;
+	}
+
+	/**
+	 * @brief Writes the deferred writes now, regardless of the wear budgets.
+	 */
+	[[nodiscard]] util::error_code flush()
+	{
+		return governor.flush();
+	}
+#endif
+
 #ifdef CONFIG_NANOPB
-	// Reading and writing of protobuf messages.
+	// Reading and writing of protobuf messages. The bodies are kept minimal, as they get
+	// instantiated for every message type: the storage access is shared by all messages.
 	template <typename type, size_t max_size>
 	[[nodiscard]] util::error_code read(uint16_t id, protobuf::message<type, max_size> &message)
 	{
-		uint8_t buffer[protobuf::message<type, max_size>::maximum_encoded_size];
+		// backends that can map records decode directly from the storage without a copy
+		using message_type = protobuf::message<type, max_size>;
+		constexpr size_t buffer_size = storage::mappable_backend<backend_type>
+						       ? 0U
+						       : message_type::maximum_encoded_size;
+		std::array<uint8_t, buffer_size> buffer;
 
-		const auto buffer_view = read(id, std::span<uint8_t>{buffer, sizeof(buffer)});
-		if (!buffer_view) {
-			return buffer_view.error();
+#ifdef CONFIG_APP_STORAGE_WEAR_GOVERNOR
+		// a deferred write is decoded from the copy of the governor, as it does not fit
+		// into the buffer of the mappable backends
+		constexpr auto decode = decode_deferred<type, max_size>;
+		if (const auto decoded = governor.visit_deferred(id, decode, &message)) {
+			return *decoded;
+		}
+#endif
+		const auto record = view(id, buffer);
+		if (!record) {
+			return record.error();
 		}
 
-		return message.decode(buffer_view.value());
+		return message.decode(record->data());
 	}
 
 	template <typename type, size_t max_size>
@@ -120,18 +613,194 @@ public:
 	{
 		std::array<uint8_t, protobuf::message<type, max_size>::maximum_encoded_size> buffer;
 
-		const auto encode_result =
-			message.encode(std::span<uint8_t>{buffer.data(), buffer.size()});
+		const auto encode_result = message.encode(buffer);
 		if (!encode_result) {
 			return encode_result.error();
 		}
 
-		return write(id, encode_result.value());
+		return write(id, std::span<const uint8_t>{encode_result.value()});
 	}
 #endif
 
 private:
-	struct nvs_fs fs;
+#ifdef CONFIG_APP_STORAGE_WEAR_GOVERNOR
+	void start_governor()
+	{
+		storage::flash_geometry geometry{};
+		if constexpr (storage::erasable_backend<backend_type>) {
+			geometry = backend.geometry();
+		}
+
+		governor.start({this,
+				[](void *self, uint16_t id, std::span<const uint8_t> data) {
+					return static_cast<basic_non_volatile_storage *>(self)
+						->write_record(id, data);
+				},
+				[](void *self, uint16_t id, std::span<uint8_t> buffer) {
+					return static_cast<basic_non_volatile_storage *>(self)
+						->read(id, buffer);
+				},
+				[](void *self, uint16_t id, std::span<const uint8_t> data) {
+					return static_cast<basic_non_volatile_storage *>(self)
+						->is_stored(id, data);
+				}},
+			       geometry);
+	}
+
+	/// Whether the record holds the data already, as the backends do not program it again then.
+	bool is_stored(uint16_t id, std::span<const uint8_t> data)
+	{
+		// records that do not fit are compared on the backends that can map them only
+		std::array<uint8_t, CONFIG_APP_STORAGE_WEAR_MAX_DEFERRED_SIZE> buffer;
+		const auto record = view(id, buffer);
+		if (!record) {
+			return data.empty() &&
+			       record.error() ==
+				       util::error_condition{util::errc::no_such_file_or_directory};
+		}
+		return std::ranges::equal(record->data(), data);
+	}
+
+#ifdef CONFIG_NANOPB
+	template <typename type, size_t max_size>
+	static util::error_code decode_deferred(void *message, std::span<const uint8_t> data)
+	{
+		return static_cast<protobuf::message<type, max_size> *>(message)->decode(data);
+	}
+#endif
+#endif
+
+#ifdef CONFIG_APP_STORAGE_SNAPSHOT
+	util::error_code restore_records(storage::snapshot::decoder &decoder)
+	{
+		const os::profiling::scoped_timer timer{"storage restore"};
+		const storage::exclusive_pin_lock lock{pins};
+#ifdef CONFIG_APP_STORAGE_RECORD_CRC
+		std::array<uint8_t, max_record_size> record_buffer;
+#endif
+		const auto next = [&]() -> storage::next_record {
+			auto record = decoder.next();
+#ifdef CONFIG_APP_STORAGE_RECORD_CRC
+			// the records get their CRC appended, like by write_record() (the decoder
+			// buffer limits their size)
+			if (record && record->has_value()) {
+				auto &entry = record->value();
+				const auto data =
+					storage::record_crc::append(*entry.data, record_buffer);
+				entry = {entry.id, data.size(), data};
+			}
+#endif
+			return record;
+		};
+
+		if constexpr (storage::restorable_backend<backend_type>) {
+			return backend.restore(next);
+		} else {
+			if (const auto error = backend.clear()) {
+				return error;
+			}
+			if (const auto error = backend.mount()) {
+				return error;
+			}
+
+			while (true) {
+				const auto record = next();
+				if (!record) {
+					return record.error();
+				}
+				if (!record->has_value()) {
+					return {};
+				}
+				if (const auto error = backend.write(record->value().id,
+								     *record->value().data)) {
+					return error;
+				}
+			}
+		}
+	}
+#endif
+
+	/// Writing of a record (with its CRC), without notifying the subscribers or the governor.
+	util::error_code write_record(uint16_t id, std::span<const uint8_t> buffer)
+	{
+		if (const auto error = mounting.wait()) {
+			return error;
+		}
+
+		const os::profiling::scoped_timer timer{"storage write"};
+#ifdef CONFIG_APP_STORAGE_RECORD_CRC
+		// deleting a record (writing empty data) does not need a CRC
+		if (!buffer.empty()) {
+			if (buffer.size() > CONFIG_APP_STORAGE_RECORD_CRC_MAX_SIZE) {
+				return storage_error_code::wrong_data_size;
+			}
+
+			std::array<uint8_t, max_record_size> record_buffer;
+			const auto record = storage::record_crc::append(buffer, record_buffer);
+
+			const storage::exclusive_pin_lock lock{pins};
+			return backend.write(id, record);
+		}
+#endif
+		const storage::exclusive_pin_lock lock{pins};
+		return backend.write(id, buffer);
+	}
+
+#ifdef CONFIG_APP_STORAGE_RECORD_CRC
+	/// Largest record including its CRC.
+	static constexpr size_t max_record_size =
+		CONFIG_APP_STORAGE_RECORD_CRC_MAX_SIZE + storage::record_crc::size;
+
+	static std::expected<std::span<uint8_t>, util::error_code>
+	copy_to(std::span<const uint8_t> data, std::span<uint8_t> buffer)
+	{
+		if (data.size() > buffer.size()) {
+			return std::unexpected{storage_error_code::wrong_data_size};
+		}
+
+		std::ranges::copy(data, buffer.begin());
+		return buffer.first(data.size());
+	}
+#endif
+
+	backend_type backend{};
+	storage::mount_runner mounting{};
+	storage::pin_lock pins{};
+#ifdef CONFIG_APP_STORAGE_NOTIFICATIONS
+	/// Whether the records belong to the instance instead of the storage partition.
+	static constexpr bool instance_records = std::is_same_v<backend_type, storage::ram_backend>;
+
+	struct no_notifier {};
+
+	storage::change_notifier &records_notifier()
+	{
+		if constexpr (instance_records) {
+			return instance_notifier;
+		} else {
+			// constructed on the first use, as the instances may be static themselves
+			static storage::change_notifier partition_notifier{};
+			return partition_notifier;
+		}
+	}
+
+	[[no_unique_address]] std::conditional_t<instance_records, storage::change_notifier,
+						 no_notifier> instance_notifier{};
+	storage::change_notifier &notifier = records_notifier();
+#endif
+#ifdef CONFIG_APP_STORAGE_WEAR_GOVERNOR
+	storage::wear_governor governor{}; ///< destroyed first, as it writes the deferred data
+#endif
 };
 
+using non_volatile_storage = basic_non_volatile_storage<storage::default_backend>;
+
+/**
+ * @brief Storage of the storage partition, which the modules of the application share.
+ *
+ * Every instance mounts the backend with its own state in RAM (e.g. the lookup structures of the
+ * backend and the wear budgets), so the modules use this instance instead of mounting further
+ * ones on the partition. It gets initialized by the application.
+ */
+non_volatile_storage &shared_storage();
+
 #endif /* STORAGE_NON_VOLATILE_STORAGE_HPP */
@@ -0,0 +1,152 @@
+#include "nvs_allocation_table.hpp"
+#include <zephyr/drivers/flash.h>
+#include <zephyr/sys/crc.h>
+#include "os/kernel.hpp"
+#include <algorithm>
+#include <cstddef>
+
+namespace storage
+{
+
+std::expected<nvs_allocation_table::entry, util::error_code>
+nvs_allocation_table::find(uint16_t id) const
+{
+	// same walk as nvs_read_hist(): from the write address backwards to the oldest ATE
+	uint32_t address = fs.ate_wra;
+	raw_entry ate{};
+
+	k_mutex_lock(&fs.nvs_lock, K_FOREVER);
+	while (true) {
+		const uint32_t ate_address = address;
+		if (const auto error = previous(address, ate)) {
+			k_mutex_unlock(&fs.nvs_lock);
+			return std::unexpected{error};
+		}
+
+		if (ate.id == id && id != special_ate_id && is_valid(ate)) {
+			// the most recent entry being empty marks a deleted record
+			const bool deleted = ate.length == 0U;
+			const uint32_t data_address = (ate_address & sector_mask) + ate.offset;
+			k_mutex_unlock(&fs.nvs_lock);
+
+			if (deleted) {
+				return std::unexpected{util::errc::no_such_file_or_directory};
+			}
+			return entry{id, data_length(ate), data_address};
+		}
+
+		if (address == fs.ate_wra) {
+			k_mutex_unlock(&fs.nvs_lock);
+			return std::unexpected{util::errc::no_such_file_or_directory};
+		}
+	}
+}
+
+uint16_t nvs_allocation_table::data_length(const raw_entry &ate)
+{
+#ifdef CONFIG_NVS_DATA_CRC
+	// the length of the ATE includes the CRC that nvs appends to the data
+	return ate.length - sizeof(uint32_t);
+#else
+	return ate.length;
+#endif
+}
+
+size_t nvs_allocation_table::ate_size() const
+{
+	const size_t write_block_size = fs.flash_parameters->write_block_size;
+	if (write_block_size <= 1U) {
+		return sizeof(raw_entry);
+	}
+	return (sizeof(raw_entry) + write_block_size - 1U) & ~(write_block_size - 1U);
+}
+
+bool nvs_allocation_table::is_valid(const raw_entry &ate) const
+{
+	const auto crc8 = crc8_ccitt(0xff, &ate, offsetof(raw_entry, crc8));
+	const uint32_t end = static_cast<uint32_t>(ate.offset) + ate.length;
+	return crc8 == ate.crc8 && end < fs.sector_size - ate_size();
+}
+
+bool nvs_allocation_table::is_valid_close(const raw_entry &ate) const
+{
+	return is_valid(ate) && ate.length == 0U && ate.id == special_ate_id &&
+	       (fs.sector_size - ate.offset) % ate_size() == 0U;
+}
+
+bool nvs_allocation_table::is_erased(const raw_entry &ate) const
+{
+	const auto *const bytes = reinterpret_cast<const uint8_t *>(&ate);
+	return std::all_of(bytes, bytes + sizeof(ate), [this](uint8_t byte) {
+		return byte == fs.flash_parameters->erase_value;
+	});
+}
+
+util::error_code nvs_allocation_table::read(uint32_t address, raw_entry &ate) const
+{
+	const auto result = flash_read(fs.flash_device, flash_offset(address), &ate, sizeof(ate));
+	return os::result_to_error_code(result);
+}
+
+util::error_code nvs_allocation_table::previous(uint32_t &address, raw_entry &ate) const
+{
+	if (const auto error = read(address, ate)) {
+		return error;
+	}
+
+	address += ate_size();
+	if ((address & offset_mask) != fs.sector_size - ate_size()) {
+		return {};
+	}
+
+	// reached the close ATE of the sector: jump to the previous sector
+	if ((address >> sector_shift) == 0U) {
+		address += (fs.sector_count - 1U) << sector_shift;
+	} else {
+		address -= 1U << sector_shift;
+	}
+
+	raw_entry close_ate{};
+	if (const auto error = read(address, close_ate)) {
+		return error;
+	}
+
+	// the previous sector was never closed: at the end of the file system
+	if (is_erased(close_ate)) {
+		address = fs.ate_wra;
+		return {};
+	}
+
+	if (is_valid_close(close_ate)) {
+		address = (address & sector_mask) + close_ate.offset;
+		return {};
+	}
+
+	return recover_last_ate(address);
+}
+
+util::error_code nvs_allocation_table::recover_last_ate(uint32_t &address) const
+{
+	// the close ATE was corrupted: search for the last valid ATE of the sector
+	address -= ate_size();
+	uint32_t ate_end_address = address;
+	uint32_t data_end_address = address & sector_mask;
+
+	while (ate_end_address > data_end_address) {
+		raw_entry ate{};
+		if (const auto error = read(ate_end_address, ate)) {
+			return error;
+		}
+
+		if (is_valid(ate)) {
+			data_end_address =
+				(data_end_address & sector_mask) + ate.offset + ate.length;
+			address = ate_end_address;
+		}
+		ate_end_address -= ate_size();
+	}
+
+	return {};
+}
+
+} // namespace storage
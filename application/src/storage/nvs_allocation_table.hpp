@@ -0,0 +1,152 @@
+#ifndef STORAGE_NVS_ALLOCATION_TABLE_HPP
+#define STORAGE_NVS_ALLOCATION_TABLE_HPP
+
+#include <zephyr/fs/nvs.h>
+#include "storage/backend.hpp"
+#include "util/system_error.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <expected>
+
+namespace storage
+{
+
+/**
+ * @brief Read access to the allocation table entries (ATEs) of a mounted nvs file system.
+ *
+ * The nvs API only allows reading records by ID. This class gives access to the location of the
+ * records in flash by walking the ATEs in the same way as nvs does. The layout and the walking
+ * logic mirror subsys/fs/nvs/nvs.c and nvs_priv.h of the Zephyr version given in west.yml and
+ * need to be kept in sync with it.
+ */
+class nvs_allocation_table
+{
+public:
+	/// Location of a record (sector in the upper, offset in the lower 16 bits, like nvs)
+	struct entry {
+		uint16_t id;
+		uint16_t length;
+		uint32_t address;
+	};
+
+	explicit nvs_allocation_table(struct nvs_fs &fs) : fs(fs)
+	{
+	}
+
+	/**
+	 * @brief Finds the most recent entry of a record.
+	 *
+	 * @return The entry, or no_such_file_or_directory if the record does not exist (anymore).
+	 */
+	[[nodiscard]] std::expected<entry, util::error_code> find(uint16_t id) const;
+
+	/**
+	 * @brief Visits every live record in the range once, from the most recently written to the
+	 *        oldest one.
+	 *
+	 * The walk goes once over the allocation table. To skip outdated entries of a record, the
+	 * IDs of already visited records are kept (at most CONFIG_APP_STORAGE_MAX_RECORDS). Entries
+	 * outside of the range are skipped before, so that they do not count against this limit.
+	 *
+	 * @param visitor Gets called with each entry and returns whether to continue the walk.
+	 * @return no_buffer_space if the range contains more than CONFIG_APP_STORAGE_MAX_RECORDS.
+	 */
+	template <typename visitor_type>
+	[[nodiscard]] util::error_code for_each(id_range range, visitor_type &&visitor) const
+	{
+		std::array<uint16_t, CONFIG_APP_STORAGE_MAX_RECORDS> seen; // sorted
+		size_t seen_count = 0;
+		uint32_t address = fs.ate_wra;
+		util::error_code error{};
+
+		k_mutex_lock(&fs.nvs_lock, K_FOREVER);
+		do {
+			const uint32_t ate_address = address;
+			raw_entry ate{};
+			error = previous(address, ate);
+			if (error) {
+				break;
+			}
+
+			if (ate.id == special_ate_id || !range.contains(ate.id) || !is_valid(ate)) {
+				continue;
+			}
+
+			// only the most recent entry of a record counts
+			const auto seen_end = seen.begin() + seen_count;
+			const auto position = std::lower_bound(seen.begin(), seen_end, ate.id);
+			if (position != seen_end && *position == ate.id) {
+				continue;
+			}
+
+			if (seen_count == seen.size()) {
+				error = util::errc::no_buffer_space;
+				break;
+			}
+			std::move_backward(position, seen_end, seen_end + 1);
+			*position = ate.id;
+			++seen_count;
+
+			// the most recent entry being empty marks a deleted record
+			if (ate.length == 0U) {
+				continue;
+			}
+
+			const uint32_t data_address = (ate_address & sector_mask) + ate.offset;
+			if (!visitor(entry{ate.id, data_length(ate), data_address})) {
+				break;
+			}
+		} while (address != fs.ate_wra);
+		k_mutex_unlock(&fs.nvs_lock);
+
+		return error;
+	}
+
+	/**
+	 * @brief Offset of an nvs address, relative to the start of the flash device.
+	 */
+	[[nodiscard]] off_t flash_offset(uint32_t address) const
+	{
+		return fs.offset + static_cast<off_t>(fs.sector_size) * (address >> sector_shift) +
+		       (address & offset_mask);
+	}
+
+private:
+	friend class nvs_bulk_writer;
+
+	/// The id that nvs uses for the close and the garbage collection done ATEs.
+	static constexpr uint16_t special_ate_id = 0xFFFFU;
+
+	static constexpr uint32_t sector_mask = 0xFFFF0000U;
+	static constexpr uint32_t sector_shift = 16U;
+	static constexpr uint32_t offset_mask = 0x0000FFFFU;
+
+	/// Layout of an ATE as written by nvs.
+	struct __packed raw_entry {
+		uint16_t id;
+		uint16_t offset;
+		uint16_t length;
+		uint8_t part;
+		uint8_t crc8;
+	};
+
+	[[nodiscard]] static uint16_t data_length(const raw_entry &ate);
+	[[nodiscard]] size_t ate_size() const;
+	[[nodiscard]] bool is_valid(const raw_entry &ate) const;
+	[[nodiscard]] bool is_valid_close(const raw_entry &ate) const;
+	[[nodiscard]] bool is_erased(const raw_entry &ate) const;
+	[[nodiscard]] util::error_code read(uint32_t address, raw_entry &ate) const;
+
+	/**
+	 * @brief Reads the ATE at the address and moves the address to the next older ATE.
+	 */
+	[[nodiscard]] util::error_code previous(uint32_t &address, raw_entry &ate) const;
+	[[nodiscard]] util::error_code recover_last_ate(uint32_t &address) const;
+
+	struct nvs_fs &fs;
+};
+
+} // namespace storage
+
+#endif /* STORAGE_NVS_ALLOCATION_TABLE_HPP */
@@ -0,0 +1,104 @@
+#include "nvs_backend.hpp"
+#include <zephyr/drivers/flash.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/storage/flash_map.h>
+#include "nvs_allocation_table.hpp"
+#include "storage_error.hpp"
+
+#ifdef CONFIG_FLASH_SIMULATOR
+#include <zephyr/drivers/flash/flash_simulator.h>
+#endif
+
+LOG_MODULE_DECLARE(non_volatile_storage);
+
+// definition of the flash partition to be used for the storage
+#define NVS_PARTITION        storage_partition
+#define NVS_PARTITION_DEVICE FIXED_PARTITION_DEVICE(NVS_PARTITION)
+#define NVS_PARTITION_OFFSET FIXED_PARTITION_OFFSET(NVS_PARTITION)
+
+namespace storage
+{
+
+#ifdef CONFIG_APP_STORAGE_MEMORY_MAPPED_FLASH
+namespace
+{
+/**
+ * @brief Address at which the flash device of the storage is mapped into memory.
+ */
+const uint8_t *mapped_flash_base(const struct device *flash_device)
+{
+#ifdef CONFIG_FLASH_SIMULATOR
+	size_t size = 0;
+	return static_cast<const uint8_t *>(flash_simulator_get_memory(flash_device, &size));
+#else
+	ARG_UNUSED(flash_device);
+	return reinterpret_cast<const uint8_t *>(DT_REG_ADDR(DT_CHOSEN(zephyr_flash)));
+#endif
+}
+} // namespace
+#endif
+
+util::error_code nvs_backend::configure()
+{
+	/* define the nvs file system by settings with:
+	 *	sector_size equal to the pagesize,
+	 *	CONFIG_APP_STORAGE_NVS_SECTOR_COUNT sectors
+	 *	starting at NVS_PARTITION_OFFSET
+	 */
+	fs.flash_device = NVS_PARTITION_DEVICE;
+	if (!device_is_ready(fs.flash_device)) {
+		LOG_ERR("Flash device %s is not ready.", fs.flash_device->name);
+		return storage_error_code::device_not_ready;
+	}
+
+	fs.offset = NVS_PARTITION_OFFSET;
+	struct flash_pages_info info;
+	auto rc = flash_get_page_info_by_offs(fs.flash_device, fs.offset, &info);
+	if (rc) {
+		LOG_ERR("%s", "Unable to get page info.");
+		return storage_error_code::unable_to_get_page_info;
+	}
+	fs.sector_size = info.size;
+	fs.sector_count = CONFIG_APP_STORAGE_NVS_SECTOR_COUNT;
+
+	return {};
+}
+
+util::error_code nvs_backend::mount()
+{
+	const os::profiling::scoped_timer timer{"nvs_mount"};
+
+	const auto rc = nvs_mount(&fs);
+	if (rc < 0) {
+		LOG_ERR("%s", "Flash Init failed.");
+		return os::result_to_error_code(rc);
+	}
+
+	return {};
+}
+
+#ifdef CONFIG_APP_STORAGE_MEMORY_MAPPED_FLASH
+std::expected<std::span<const uint8_t>, util::error_code> nvs_backend::map(uint16_t id)
+{
+	// same behavior as nvs_read() for a file system that was not mounted
+	if (!fs.ready) {
+		return std::unexpected{util::errc::permission_denied};
+	}
+
+	const nvs_allocation_table table{fs};
+	const auto entry = table.find(id);
+	if (!entry) {
+		return std::unexpected{entry.error()};
+	}
+
+	const auto *const data = mapped_flash() + table.flash_offset(entry->address);
+	return std::span<const uint8_t>{data, entry->length};
+}
+
+const uint8_t *nvs_backend::mapped_flash() const
+{
+	return mapped_flash_base(fs.flash_device);
+}
+#endif
+
+} // namespace storage
@@ -0,0 +1,141 @@
+#ifndef STORAGE_NVS_BACKEND_HPP
+#define STORAGE_NVS_BACKEND_HPP
+
+#include <zephyr/fs/nvs.h>
+#include "os/kernel.hpp"
+#include "storage/backend.hpp"
+#include "storage/nvs_allocation_table.hpp"
+#include "storage/nvs_bulk_writer.hpp"
+#include <expected>
+#include <optional>
+#include <span>
+
+namespace storage
+{
+
+/**
+ * @brief Storage backend on the 'nvs' module of Zephyr.
+ */
+class nvs_backend
+{
+public:
+	[[nodiscard]] util::error_code configure();
+	[[nodiscard]] util::error_code mount();
+
+	[[nodiscard]] util::error_code clear()
+	{
+		const auto result = nvs_clear(&fs);
+		return os::result_to_error_code(result);
+	}
+
+	[[nodiscard]] std::expected<size_t, util::error_code> read(uint16_t id,
+								    std::span<uint8_t> buffer)
+	{
+		const auto result = nvs_read(&fs, id, buffer.data(), buffer.size());
+		const auto error = os::result_to_error_code(result);
+		if (error) {
+			return std::unexpected{error};
+		}
+
+		// if the result was not an error (was not < 0), then it indicates the record length
+		return static_cast<size_t>(result);
+	}
+
+	[[nodiscard]] util::error_code write(uint16_t id, std::span<const uint8_t> data)
+	{
+		const auto result = nvs_write(&fs, id, data.data(), data.size());
+		return os::result_to_error_code(result);
+	}
+
+	/**
+	 * @brief Visits every stored record in the range once, in a single walk over the allocation
+	 *        table.
+	 *
+	 * With CONFIG_APP_STORAGE_MEMORY_MAPPED_FLASH, the data of the records is mapped from the
+	 * location in the allocation table, without searching the records again.
+	 *
+	 * @param visitor Gets called as visitor(entry) and returns whether to continue.
+	 */
+	template <typename visitor_type>
+	[[nodiscard]] util::error_code for_each(id_range range, visitor_type &&visitor)
+	{
+		// same behavior as nvs_read() for a file system that was not mounted
+		if (!fs.ready) {
+			return util::errc::permission_denied;
+		}
+
+		const nvs_allocation_table table{fs};
+		return table.for_each(range, [&](const nvs_allocation_table::entry &entry) {
+			record_entry record{entry.id, entry.length, std::nullopt};
+#ifdef CONFIG_APP_STORAGE_MEMORY_MAPPED_FLASH
+			record.data = std::span<const uint8_t>{
+				mapped_flash() + table.flash_offset(entry.address), entry.length};
+#endif
+			return visitor(record);
+		});
+	}
+
+#ifndef CONFIG_NVS_DATA_CRC
+	/**
+	 * @brief Replaces all records by the records that next() returns, written sequentially into
+	 *        the erased sectors (see nvs_bulk_writer).
+	 *
+	 * Not available with CONFIG_NVS_DATA_CRC, as the bulk writer does not append the data CRC
+	 * of nvs.
+	 *
+	 * @param next Returns the next record, nothing after the last one, or an error.
+	 */
+	template <typename source_type>
+	[[nodiscard]] util::error_code restore(source_type &&next)
+	{
+		if (const auto error = clear()) {
+			return error;
+		}
+
+		nvs_bulk_writer writer{fs};
+		util::error_code error{};
+		while (!error) {
+			const auto record = next();
+			if (!record) {
+				error = record.error();
+			} else if (!record->has_value()) {
+				break;
+			} else {
+				error = writer.write((*record)->id, *(*record)->data);
+			}
+		}
+
+		// the records written until an error are kept as well
+		const auto finished = writer.finish();
+		const auto mounted = mount();
+		if (error) {
+			return error;
+		}
+		return finished ? finished : mounted;
+	}
+#endif
+
+	[[nodiscard]] flash_geometry geometry() const
+	{
+		return {fs.sector_size, fs.sector_count};
+	}
+
+#ifdef CONFIG_APP_STORAGE_MEMORY_MAPPED_FLASH
+	/**
+	 * @brief Access to a record directly in the memory-mapped flash.
+	 */
+	[[nodiscard]] std::expected<std::span<const uint8_t>, util::error_code> map(uint16_t id);
+#endif
+
+private:
+#ifdef CONFIG_APP_STORAGE_MEMORY_MAPPED_FLASH
+	/// Address at which the flash device of the storage is mapped into memory.
+	[[nodiscard]] const uint8_t *mapped_flash() const;
+#endif
+
+	struct nvs_fs fs{};
+};
+
+} // namespace storage
+
+#endif /* STORAGE_NVS_BACKEND_HPP */
@@ -0,0 +1,164 @@
+#include "nvs_bulk_writer.hpp"
+#include <zephyr/drivers/flash.h>
+#include <zephyr/sys/crc.h>
+#include "os/kernel.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace storage
+{
+
+nvs_bulk_writer::nvs_bulk_writer(struct nvs_fs &fs)
+	: fs{fs}, table{fs}, ate_size{table.ate_size()},
+	  write_block_size{fs.flash_parameters->write_block_size},
+	  // like a freshly erased file system: the first ATE goes below the close ATE of sector 0
+	  ate_address{static_cast<uint32_t>(fs.sector_size - 2U * ate_size)}, data_address{0U},
+	  batch_capacity{batch_size / ate_size}
+{
+}
+
+util::error_code nvs_bulk_writer::write(uint16_t id, std::span<const uint8_t> data)
+{
+	if (batch_capacity == 0U || write_block_size > max_write_block_size) {
+		return util::errc::not_supported;
+	}
+
+	// same limit as nvs_write()
+	if (data.empty() || data.size() > fs.sector_size - 3U * ate_size) {
+		return util::errc::invalid_argument;
+	}
+
+	// same check as nvs_write(): the ATE needs to fit between the data and the last ATE
+	const size_t data_size = aligned(data.size());
+	if ((ate_address & table.offset_mask) <
+	    (data_address & table.offset_mask) + data_size + ate_size) {
+		if (const auto error = close_sector()) {
+			return error;
+		}
+	}
+
+	raw_entry ate{};
+	ate.id = id;
+	ate.offset = static_cast<uint16_t>(data_address & table.offset_mask);
+	ate.length = static_cast<uint16_t>(data.size());
+	ate.part = 0xffU;
+	ate.crc8 = crc8_ccitt(0xff, &ate, offsetof(raw_entry, crc8));
+
+	// the data is written before its ATE, so that an interrupted restore leaves no ATE behind
+	// that points to missing data
+	if (const auto error = write_data(data)) {
+		return error;
+	}
+	data_address += data_size;
+
+	return add_entry(ate);
+}
+
+util::error_code nvs_bulk_writer::finish()
+{
+	return write_entries();
+}
+
+size_t nvs_bulk_writer::aligned(size_t size) const
+{
+	if (write_block_size <= 1U) {
+		return size;
+	}
+	return (size + write_block_size - 1U) & ~(write_block_size - 1U);
+}
+
+util::error_code nvs_bulk_writer::write_data(std::span<const uint8_t> data)
+{
+	// like nvs_flash_al_wrt(): the unaligned end is padded with the erase value
+	const size_t aligned_size = data.size() & ~(std::max<size_t>(write_block_size, 1U) - 1U);
+	if (aligned_size > 0U) {
+		if (const auto error = write_flash(data_address, data.first(aligned_size))) {
+			return error;
+		}
+	}
+
+	const auto rest = data.subspan(aligned_size);
+	if (rest.empty()) {
+		return {};
+	}
+
+	std::array<uint8_t, max_write_block_size> block;
+	std::ranges::fill(block, fs.flash_parameters->erase_value);
+	std::ranges::copy(rest, block.begin());
+	return write_flash(data_address + aligned_size,
+			   std::span{block}.first(std::max<size_t>(write_block_size, 1U)));
+}
+
+util::error_code nvs_bulk_writer::close_sector()
+{
+	// like nvs_sector_close(), but the last sector stays erased for the garbage collection
+	const uint32_t next_sector = (ate_address >> table.sector_shift) + 1U;
+	if (next_sector + 1U >= fs.sector_count) {
+		return util::errc::no_space_on_device;
+	}
+
+	if (const auto error = write_entries()) {
+		return error;
+	}
+
+	raw_entry close{};
+	close.id = table.special_ate_id;
+	close.offset = static_cast<uint16_t>((ate_address + ate_size) & table.offset_mask);
+	close.length = 0U;
+	close.part = 0xffU;
+	close.crc8 = crc8_ccitt(0xff, &close, offsetof(raw_entry, crc8));
+
+	std::array<uint8_t, batch_size> slot;
+	std::ranges::fill(slot, fs.flash_parameters->erase_value);
+	std::memcpy(slot.data(), &close, sizeof(close));
+	const uint32_t close_address =
+		(ate_address & table.sector_mask) + fs.sector_size - ate_size;
+	if (const auto error = write_flash(close_address, std::span{slot}.first(ate_size))) {
+		return error;
+	}
+
+	data_address = next_sector << table.sector_shift;
+	ate_address = data_address + fs.sector_size - 2U * ate_size;
+	return {};
+}
+
+util::error_code nvs_bulk_writer::add_entry(const raw_entry &ate)
+{
+	if (batch_count == 0U) {
+		std::ranges::fill(batch, fs.flash_parameters->erase_value);
+	}
+
+	// the ATEs grow downwards, so the batch is filled from its end
+	const size_t position = (batch_capacity - batch_count - 1U) * ate_size;
+	std::memcpy(&batch[position], &ate, sizeof(ate));
+	++batch_count;
+	ate_address -= ate_size;
+
+	if (batch_count == batch_capacity) {
+		return write_entries();
+	}
+	return {};
+}
+
+util::error_code nvs_bulk_writer::write_entries()
+{
+	if (batch_count == 0U) {
+		return {};
+	}
+
+	// the collected ATEs are the ones right above the next ATE
+	const size_t size = batch_count * ate_size;
+	const auto entries = std::span{batch}.subspan(batch_capacity * ate_size - size, size);
+	batch_count = 0U;
+	return write_flash(ate_address + ate_size, entries);
+}
+
+util::error_code nvs_bulk_writer::write_flash(uint32_t address, std::span<const uint8_t> data)
+{
+	const auto result =
+		flash_write(fs.flash_device, table.flash_offset(address), data.data(), data.size());
+	return os::result_to_error_code(result);
+}
+
+} // namespace storage
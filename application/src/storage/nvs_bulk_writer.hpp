@@ -0,0 +1,76 @@
+#ifndef STORAGE_NVS_BULK_WRITER_HPP
+#define STORAGE_NVS_BULK_WRITER_HPP
+
+#include <zephyr/fs/nvs.h>
+#include "storage/nvs_allocation_table.hpp"
+#include "util/system_error.hpp"
+#include <array>
+#include <cstdint>
+#include <span>
+
+namespace storage
+{
+
+/**
+ * @brief Sequential writing of records into the erased sectors of an nvs file system.
+ *
+ * nvs_write() searches the allocation table for the previous data of every record and writes
+ * its ATE separately. For a file system that was just erased, both are unnecessary: the data is
+ * laid out like nvs does it (upwards from the start of a sector, the ATEs downwards from its
+ * end), the ATEs are collected and written in batches and a full sector is closed before the
+ * next one is used. The last sector stays erased for the garbage collection of nvs.
+ *
+ * The layout mirrors subsys/fs/nvs/nvs.c of the Zephyr version given in west.yml (like
+ * nvs_allocation_table) and needs to be kept in sync with it. The file system needs to be
+ * mounted again afterwards, which finds the written records.
+ */
+class nvs_bulk_writer
+{
+public:
+	/**
+	 * @param fs File system that was configured and whose sectors are all erased.
+	 */
+	explicit nvs_bulk_writer(struct nvs_fs &fs);
+
+	/**
+	 * @return invalid_argument for empty data or data that nvs_write() would reject as well,
+	 *         no_space_on_device if all sectors but the last one are full.
+	 */
+	[[nodiscard]] util::error_code write(uint16_t id, std::span<const uint8_t> data);
+
+	/**
+	 * @brief Writes the collected ATEs.
+	 */
+	[[nodiscard]] util::error_code finish();
+
+private:
+	using raw_entry = nvs_allocation_table::raw_entry;
+
+	/// Bytes of ATEs that are collected before they are written at once.
+	static constexpr size_t batch_size = 128U;
+	/// Largest write block size for which the unaligned end of the data can be padded.
+	static constexpr size_t max_write_block_size = 32U;
+
+	[[nodiscard]] size_t aligned(size_t size) const;
+	[[nodiscard]] util::error_code write_data(std::span<const uint8_t> data);
+	[[nodiscard]] util::error_code close_sector();
+	[[nodiscard]] util::error_code write_flash(uint32_t address, std::span<const uint8_t> data);
+	[[nodiscard]] util::error_code add_entry(const raw_entry &ate);
+	[[nodiscard]] util::error_code write_entries();
+
+	struct nvs_fs &fs;
+	nvs_allocation_table table;
+	size_t ate_size;
+	size_t write_block_size;
+	uint32_t ate_address;  ///< where the next ATE goes (like fs->ate_wra)
+	uint32_t data_address; ///< where the next data goes (like fs->data_wra)
+
+	/// ATEs in the order of their addresses, filled from the end like the sector.
+	std::array<uint8_t, batch_size> batch;
+	size_t batch_capacity;
+	size_t batch_count = 0U;
+};
+
+} // namespace storage
+
+#endif /* STORAGE_NVS_BULK_WRITER_HPP */
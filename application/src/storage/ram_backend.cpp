@@ -0,0 +1,98 @@
+#include "ram_backend.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace storage
+{
+
+util::error_code ram_backend::clear()
+{
+	record_count = 0;
+	pool_used = 0;
+	return {};
+}
+
+std::expected<size_t, util::error_code> ram_backend::read(uint16_t id, std::span<uint8_t> buffer)
+{
+	const auto data = map(id);
+	if (!data) {
+		return std::unexpected{data.error()};
+	}
+
+	// like the flash backends, copy as much as fits and return the length of the record
+	std::memcpy(buffer.data(), data->data(), std::min(data->size(), buffer.size()));
+	return data->size();
+}
+
+std::expected<std::span<const uint8_t>, util::error_code> ram_backend::map(uint16_t id)
+{
+	const auto *const entry = lower_bound(id);
+	if (entry == records.data() + record_count || entry->id != id) {
+		return std::unexpected{util::errc::no_such_file_or_directory};
+	}
+
+	return std::span<const uint8_t>{pool.data() + entry->offset, entry->length};
+}
+
+util::error_code ram_backend::write(uint16_t id, std::span<const uint8_t> data)
+{
+	auto *entry = lower_bound(id);
+	const auto *const end = records.data() + record_count;
+	const bool exists = entry != end && entry->id == id;
+
+	if (exists && entry->length == data.size()) {
+		// same size: update in place
+		std::memcpy(pool.data() + entry->offset, data.data(), data.size());
+		return {};
+	}
+
+	const size_t available = pool.size() - pool_used + (exists ? entry->length : 0U);
+	const bool table_full = !exists && record_count == records.size();
+	if (data.size() > available || (table_full && !data.empty())) {
+		return util::errc::no_space_on_device;
+	}
+
+	if (exists) {
+		remove(entry);
+	}
+
+	// writing empty data deletes the record (like nvs)
+	if (data.empty()) {
+		return {};
+	}
+
+	const auto index = entry - records.data();
+	std::move_backward(records.begin() + index, records.begin() + record_count,
+			   records.begin() + record_count + 1);
+	records[index] = {id, static_cast<uint16_t>(pool_used), static_cast<uint16_t>(data.size())};
+	++record_count;
+
+	std::memcpy(pool.data() + pool_used, data.data(), data.size());
+	pool_used += data.size();
+	return {};
+}
+
+ram_backend::record *ram_backend::lower_bound(uint16_t id)
+{
+	return std::lower_bound(records.data(), records.data() + record_count, id,
+				[](const record &entry, uint16_t id) { return entry.id < id; });
+}
+
+void ram_backend::remove(record *entry)
+{
+	// close the gap in the pool, so that it stays compact
+	const auto gap_end = entry->offset + entry->length;
+	std::memmove(pool.data() + entry->offset, pool.data() + gap_end, pool_used - gap_end);
+	pool_used -= entry->length;
+
+	for (size_t i = 0; i < record_count; ++i) {
+		if (records[i].offset > entry->offset) {
+			records[i].offset -= entry->length;
+		}
+	}
+
+	std::move(entry + 1, records.data() + record_count, entry);
+	--record_count;
+}
+
+} // namespace storage
@@ -0,0 +1,89 @@
+#ifndef STORAGE_RAM_BACKEND_HPP
+#define STORAGE_RAM_BACKEND_HPP
+
+#include "storage/backend.hpp"
+#include "util/system_error.hpp"
+#include <array>
+#include <cstdint>
+#include <expected>
+#include <span>
+
+namespace storage
+{
+
+/**
+ * @brief Storage backend that keeps all records in RAM.
+ *
+ * The records do not survive a reboot. The backend is meant for volatile data and for comparing
+ * the overhead of the flash backends.
+ */
+class ram_backend
+{
+public:
+	[[nodiscard]] util::error_code configure()
+	{
+		return {};
+	}
+
+	[[nodiscard]] util::error_code mount()
+	{
+		return {};
+	}
+
+	[[nodiscard]] util::error_code clear();
+	[[nodiscard]] std::expected<size_t, util::error_code> read(uint16_t id,
+								    std::span<uint8_t> buffer);
+	[[nodiscard]] util::error_code write(uint16_t id, std::span<const uint8_t> data);
+
+	/**
+	 * @brief Access to a record directly in the data pool.
+	 */
+	[[nodiscard]] std::expected<std::span<const uint8_t>, util::error_code> map(uint16_t id);
+
+	/**
+	 * @brief Visits every stored record in the range once (in order of the IDs).
+	 *
+	 * The walk starts at the first ID of the range, as the records are sorted.
+	 *
+	 * @param visitor Gets called as visitor(entry) and returns whether to continue.
+	 */
+	template <typename visitor_type>
+	[[nodiscard]] util::error_code for_each(id_range range, visitor_type &&visitor)
+	{
+		const auto *const end = records.data() + record_count;
+		for (const auto *entry = lower_bound(range.first);
+		     (entry != end) && (entry->id <= range.last); ++entry) {
+			const std::span<const uint8_t> data{pool.data() + entry->offset,
+							    entry->length};
+			if (!visitor(record_entry{entry->id, data.size(), data})) {
+				break;
+			}
+		}
+		return {};
+	}
+
+private:
+	struct record {
+		uint16_t id;
+		uint16_t offset; ///< offset of the record data in the data pool
+		uint16_t length;
+	};
+
+	/**
+	 * @brief Binary search for the record with the given ID (records are sorted by ID).
+	 *
+	 * @return The record with the ID, or the position where it needs to be inserted.
+	 */
+	record *lower_bound(uint16_t id);
+
+	void remove(record *entry);
+
+	std::array<record, CONFIG_APP_STORAGE_RAM_BACKEND_MAX_RECORDS> records{};
+	size_t record_count = 0;
+	std::array<uint8_t, CONFIG_APP_STORAGE_RAM_BACKEND_SIZE> pool{};
+	size_t pool_used = 0; ///< data of all records is stored without gaps at the pool begin
+};
+
+} // namespace storage
+
+#endif /* STORAGE_RAM_BACKEND_HPP */
@@ -0,0 +1,64 @@
+#ifndef STORAGE_RECORD_CRC_HPP
+#define STORAGE_RECORD_CRC_HPP
+
+#include <zephyr/sys/byteorder.h>
+#include "storage/storage_error.hpp"
+#include "util/crc32.hpp"
+#include <algorithm>
+#include <expected>
+#include <span>
+
+/**
+ * @brief CRC32 that is stored (little endian) behind the data of every record.
+ */
+namespace storage::record_crc
+{
+
+constexpr size_t size = sizeof(uint32_t);
+
+inline uint32_t calculate(std::span<const uint8_t> data)
+{
+#ifdef CONFIG_APP_STORAGE_RECORD_CRC_SLICE_BY_8
+	return util::crc32::calculate_slice_by_8(data);
+#else
+	return util::crc32::calculate(data);
+#endif
+}
+
+/**
+ * @brief Copies the data into the buffer and appends its CRC.
+ *
+ * @param data The data of the record.
+ * @param buffer Buffer with space for the data and the CRC.
+ * @return The record as to be written into the storage.
+ */
+inline std::span<const uint8_t> append(std::span<const uint8_t> data, std::span<uint8_t> buffer)
+{
+	std::ranges::copy(data, buffer.begin());
+	sys_put_le32(calculate(data), &buffer[data.size()]);
+	return buffer.first(data.size() + size);
+}
+
+/**
+ * @brief Verifies the CRC of a record read from the storage.
+ *
+ * @return The data of the record without the CRC, or checksum_mismatch.
+ */
+inline std::expected<std::span<const uint8_t>, util::error_code>
+verify(std::span<const uint8_t> record)
+{
+	if (record.size() < size) {
+		return std::unexpected{storage_error_code::checksum_mismatch};
+	}
+
+	const auto data = record.first(record.size() - size);
+	if (sys_get_le32(&record[data.size()]) != calculate(data)) {
+		return std::unexpected{storage_error_code::checksum_mismatch};
+	}
+
+	return data;
+}
+
+} // namespace storage::record_crc
+
+#endif /* STORAGE_RECORD_CRC_HPP */
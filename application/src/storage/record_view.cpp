@@ -0,0 +1,42 @@
+#include "record_view.hpp"
+
+namespace storage
+{
+
+pin_lock::pin_lock()
+{
+	k_mutex_init(&mutex);
+	k_condvar_init(&unpinned);
+}
+
+void pin_lock::pin()
+{
+	k_mutex_lock(&mutex, K_FOREVER);
+	++pins;
+	k_mutex_unlock(&mutex);
+}
+
+void pin_lock::unpin()
+{
+	k_mutex_lock(&mutex, K_FOREVER);
+	if (--pins == 0U) {
+		k_condvar_broadcast(&unpinned);
+	}
+	k_mutex_unlock(&mutex);
+}
+
+void pin_lock::lock()
+{
+	// the mutex stays locked until unlock(), so that no new pins are taken during the write
+	k_mutex_lock(&mutex, K_FOREVER);
+	while (pins > 0U) {
+		k_condvar_wait(&unpinned, &mutex, K_FOREVER);
+	}
+}
+
+void pin_lock::unlock()
+{
+	k_mutex_unlock(&mutex);
+}
+
+} // namespace storage
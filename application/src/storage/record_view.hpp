@@ -0,0 +1,132 @@
+#ifndef STORAGE_RECORD_VIEW_HPP
+#define STORAGE_RECORD_VIEW_HPP
+
+#include <zephyr/kernel.h>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+namespace storage
+{
+
+/**
+ * @brief Pinning of records against relocation by the storage backend.
+ *
+ * Records are only relocated by writes (e.g. by the garbage collection of nvs). Writers hence
+ * lock the pin lock exclusively, which waits until no record is pinned anymore.
+ */
+class pin_lock
+{
+public:
+	pin_lock();
+
+	pin_lock(const pin_lock &) = delete;
+	pin_lock &operator=(const pin_lock &) = delete;
+
+	void pin();
+	void unpin();
+
+	/**
+	 * @brief Exclusive locking for writers (waits until all records were unpinned).
+	 *
+	 * A thread must not write to the storage while it holds a pinned record itself, as it would
+	 * wait for itself then.
+	 */
+	void lock();
+	void unlock();
+
+private:
+	struct k_mutex mutex;
+	struct k_condvar unpinned;
+	size_t pins = 0;
+};
+
+/**
+ * @brief RAII helper for the exclusive locking of a pin lock.
+ */
+class exclusive_pin_lock
+{
+public:
+	explicit exclusive_pin_lock(pin_lock &lock) : lock(lock)
+	{
+		lock.lock();
+	}
+
+	~exclusive_pin_lock()
+	{
+		lock.unlock();
+	}
+
+	exclusive_pin_lock(const exclusive_pin_lock &) = delete;
+	exclusive_pin_lock &operator=(const exclusive_pin_lock &) = delete;
+
+private:
+	pin_lock &lock;
+};
+
+/**
+ * @brief Read-only view of a stored record.
+ *
+ * If the view points directly into the (memory-mapped) storage, the record stays pinned until
+ * the view is destroyed. Otherwise, the view points to the buffer the record was copied into.
+ */
+class record_view
+{
+public:
+	/**
+	 * @param data The data of the record.
+	 * @param pinned_by The lock the record was already pinned with, or nullptr for copied data.
+	 */
+	record_view(std::span<const uint8_t> data, pin_lock *pinned_by)
+		: record(data), pinned_by(pinned_by)
+	{
+	}
+
+	~record_view()
+	{
+		if (pinned_by) {
+			pinned_by->unpin();
+		}
+	}
+
+	record_view(record_view &&other) noexcept
+		: record(other.record), pinned_by(std::exchange(other.pinned_by, nullptr))
+	{
+	}
+
+	record_view &operator=(record_view &&other) noexcept
+	{
+		if (this != &other) {
+			if (pinned_by) {
+				pinned_by->unpin();
+			}
+			record = other.record;
+			pinned_by = std::exchange(other.pinned_by, nullptr);
+		}
+		return *this;
+	}
+
+	record_view(const record_view &) = delete;
+	record_view &operator=(const record_view &) = delete;
+
+	[[nodiscard]] std::span<const uint8_t> data() const
+	{
+		return record;
+	}
+
+	/**
+	 * @brief Whether the view points directly into the storage (instead of to a copy).
+	 */
+	[[nodiscard]] bool is_zero_copy() const
+	{
+		return pinned_by != nullptr;
+	}
+
+private:
+	std::span<const uint8_t> record;
+	pin_lock *pinned_by;
+};
+
+} // namespace storage
+
+#endif /* STORAGE_RECORD_VIEW_HPP */
@@ -0,0 +1,200 @@
+#ifndef STORAGE_SCRUBBER_HPP
+#define STORAGE_SCRUBBER_HPP
+
+#include <zephyr/kernel.h>
+#include "storage/non_volatile_storage.hpp"
+#include "storage/storage_error.hpp"
+#include "util/static_vector.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <expected>
+
+namespace storage
+{
+
+/**
+ * @brief Walks all records of a storage and verifies their CRC (see CONFIG_APP_STORAGE_RECORD_CRC).
+ *
+ * The records are read at a limited rate of bytes per second, so that a low priority scrubber
+ * thread does not keep the storage locked for long and finds bit rot in records that are rarely
+ * read. Corrupted records are reported, but not modified.
+ *
+ * The IDs of the records are listed in pages of ID ranges, each with at most
+ * CONFIG_APP_STORAGE_MAX_RECORDS records, so that storages with more records are scrubbed
+ * completely as well.
+ */
+template <storage::backend backend_type>
+	requires storage::enumerable_backend<backend_type>
+class scrubber
+{
+public:
+	/// Gets called for every record that could not be verified.
+	using report_function = void (*)(uint16_t id, util::error_code error);
+
+	scrubber(basic_non_volatile_storage<backend_type> &storage, report_function report)
+		: storage{storage}, report{report}
+	{
+	}
+
+	~scrubber()
+	{
+		stop();
+	}
+
+	scrubber(const scrubber &) = delete;
+	scrubber &operator=(const scrubber &) = delete;
+
+	/**
+	 * @brief Starts the scrubber thread, which scrubs the storage every
+	 *        CONFIG_APP_STORAGE_SCRUBBER_INTERVAL seconds.
+	 */
+	void start()
+	{
+		stopping = false;
+		k_thread_create(&thread, stack, K_THREAD_STACK_SIZEOF(stack), thread_entry, this,
+				nullptr, nullptr, CONFIG_APP_STORAGE_SCRUBBER_THREAD_PRIORITY, 0,
+				K_NO_WAIT);
+		k_thread_name_set(&thread, "storage_scrubber");
+		running = true;
+	}
+
+	/**
+	 * @brief Stops the scrubber thread and waits for it to exit.
+	 */
+	void stop()
+	{
+		if (!running) {
+			return;
+		}
+
+		stopping = true;
+		k_wakeup(&thread);
+		k_thread_join(&thread, K_FOREVER);
+		running = false;
+	}
+
+	/**
+	 * @brief Verifies all records once.
+	 *
+	 * @param bytes_per_second Maximum rate at which the records are read.
+	 * @return The number of records that failed the verification, or the error of the walk.
+	 */
+	std::expected<size_t, util::error_code> scrub(uint32_t bytes_per_second)
+	{
+		const util::error_code deleted{util::errc::no_such_file_or_directory};
+		const int64_t start_time = k_uptime_get();
+		size_t scrubbed_bytes = 0U;
+		size_t corruptions = 0U;
+		uint32_t first = 0U;
+		uint32_t width = id_count;
+		while ((first < id_count) && !stopping) {
+			// the IDs are collected first, as the storage can not be read at a limited
+			// rate while the walk blocks all writes
+			if (const auto error = collect(first, width)) {
+				return std::unexpected{error};
+			}
+
+			for (size_t index = 0U; (index < ids.size()) && !stopping; index++) {
+				// the view pins the record, so it must be released before sleeping
+				const auto error = verify(ids[index], scrubbed_bytes);
+				// records that were deleted since the walk are not corrupted
+				if (error && (error != deleted)) {
+					report(ids[index], error);
+					corruptions++;
+				}
+
+				// sleep until the scrubbed bytes are within the rate limit again
+				const int64_t due_time =
+					start_time + (static_cast<int64_t>(scrubbed_bytes) * 1000) /
+							     bytes_per_second;
+				const int64_t now = k_uptime_get();
+				if (due_time > now) {
+					k_msleep(static_cast<int32_t>(due_time - now));
+				}
+			}
+
+			// the next page follows this one, in a wider range if this one was sparse
+			first += width;
+			if (ids.size() < ids.capacity() / 2U) {
+				width = std::min(2U * width, id_count);
+			}
+		}
+
+		return corruptions;
+	}
+
+private:
+	/// Number of record IDs.
+	static constexpr uint32_t id_count = UINT16_MAX + 1U;
+
+	/**
+	 * @brief Collects the IDs of the records in the range of the width from the first ID on.
+	 *
+	 * If the records of the range do not fit into the table of IDs (or of the walk of the
+	 * backend), the width is halved until they do.
+	 *
+	 * @return no_buffer_space if not even a single ID fits, or the error of the walk.
+	 */
+	util::error_code collect(uint32_t first, uint32_t &width)
+	{
+		const util::error_code no_buffer_space{util::errc::no_buffer_space};
+		while (true) {
+			const storage::id_range range{
+				static_cast<uint16_t>(first),
+				static_cast<uint16_t>(std::min(first + width, id_count) - 1U)};
+			bool overflow = false;
+			ids.clear();
+			auto error = storage.for_each_id(range, [this, &overflow](uint16_t id) {
+				overflow = !ids.push_back(id);
+				return !overflow;
+			});
+			if (overflow) {
+				error = no_buffer_space;
+			}
+			if ((error != no_buffer_space) || (width == 1U)) {
+				return error;
+			}
+			width /= 2U;
+		}
+	}
+
+	util::error_code verify(uint16_t id, size_t &scrubbed_bytes)
+	{
+		const auto record = storage.view(id, buffer);
+		if (!record) {
+			return record.error();
+		}
+
+		scrubbed_bytes += record->data().size();
+		return {};
+	}
+
+	static void thread_entry(void *self, void *, void *)
+	{
+		auto &scrubber = *static_cast<class scrubber *>(self);
+
+		while (!scrubber.stopping) {
+			(void)scrubber.scrub(CONFIG_APP_STORAGE_SCRUBBER_RATE);
+			if (!scrubber.stopping) {
+				k_sleep(K_SECONDS(CONFIG_APP_STORAGE_SCRUBBER_INTERVAL));
+			}
+		}
+	}
+
+	basic_non_volatile_storage<backend_type> &storage;
+	report_function report;
+
+	util::static_vector<uint16_t, CONFIG_APP_STORAGE_MAX_RECORDS> ids{};
+	/// Record buffer for backends that can not map records.
+	std::array<uint8_t, CONFIG_APP_STORAGE_RECORD_CRC_MAX_SIZE> buffer{};
+
+	std::atomic<bool> stopping{false};
+	bool running = false;
+	struct k_thread thread;
+	K_THREAD_STACK_MEMBER(stack, CONFIG_APP_STORAGE_SCRUBBER_THREAD_STACK_SIZE);
+};
+
+} // namespace storage
+
+#endif /* STORAGE_SCRUBBER_HPP */
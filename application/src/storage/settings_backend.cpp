@@ -0,0 +1,320 @@
+#include "settings_backend.hpp"
+#include <zephyr/logging/log.h>
+#include "os/kernel.hpp"
+#include <algorithm>
+#include <cstring>
+
+LOG_MODULE_REGISTER(settings_backend);
+
+static_assert(CONFIG_APP_SETTINGS_FIRST_ID + CONFIG_APP_SETTINGS_MAX_ENTRIES - 1 <= UINT16_MAX,
+	      "the IDs of the settings exceed the record IDs");
+
+#ifdef CONFIG_APP_STORAGE_WEAR_GOVERNOR
+static_assert(CONFIG_APP_STORAGE_WEAR_RECORD_ID < CONFIG_APP_SETTINGS_FIRST_ID ||
+		      CONFIG_APP_STORAGE_WEAR_RECORD_ID >=
+			      CONFIG_APP_SETTINGS_FIRST_ID + CONFIG_APP_SETTINGS_MAX_ENTRIES,
+	      "the IDs of the settings include the record of the wear accounting");
+#endif
+
+namespace storage
+{
+
+namespace
+{
+
+constexpr uint16_t first_id = CONFIG_APP_SETTINGS_FIRST_ID;
+constexpr id_range settings_ids{
+	first_id, static_cast<uint16_t>(first_id + CONFIG_APP_SETTINGS_MAX_ENTRIES - 1)};
+
+/**
+ * @brief FNV-1a hash of a name.
+ */
+constexpr uint32_t hash(std::string_view name)
+{
+	uint32_t value = 2166136261U;
+	for (const char character : name) {
+		value = (value ^ static_cast<uint8_t>(character)) * 16777619U;
+	}
+	return value;
+}
+
+/**
+ * @brief Bits of a hash in the filter of the parents of a name.
+ */
+constexpr uint32_t filter_bits(uint32_t name_hash)
+{
+	return (1U << (name_hash & 31U)) | (1U << ((name_hash >> 5U) & 31U));
+}
+
+constexpr uint32_t parents_filter(std::string_view name)
+{
+	uint32_t filter = 0U;
+	for (auto separator = name.find(SETTINGS_NAME_SEPARATOR); separator != name.npos;
+	     separator = name.find(SETTINGS_NAME_SEPARATOR, separator + 1U)) {
+		filter |= filter_bits(hash(name.substr(0U, separator)));
+	}
+	return filter;
+}
+
+ssize_t read_value(void *argument, void *data, size_t length)
+{
+	const auto &value = *static_cast<const std::span<const uint8_t> *>(argument);
+	const size_t size = std::min(length, value.size());
+	std::memcpy(data, value.data(), size);
+	return static_cast<ssize_t>(size);
+}
+
+} // namespace
+
+settings_backend::settings_backend(non_volatile_storage &storage) : storage(storage)
+{
+	static const struct settings_store_itf interface = {
+		.csi_load = load_settings,
+		.csi_save_start = nullptr,
+		.csi_save = save_setting,
+		.csi_save_end = nullptr,
+		.csi_storage_get = nullptr,
+	};
+	store.store.cs_itf = &interface;
+	store.backend = this;
+}
+
+util::error_code settings_backend::init()
+{
+	// the range of IDs has as many IDs as the index has entries, so it cannot run full
+	index.clear();
+	by_name.clear();
+	return storage.for_each(settings_ids, [this](const record_entry &entry) {
+		std::optional<std::span<const uint8_t>> record = entry.data;
+		if (!record) {
+			const auto read = storage.read(entry.id, buffer);
+			record = read ? std::optional{*read} : std::nullopt;
+		}
+
+		const auto stored = record ? parse(*record) : std::nullopt;
+		if (!stored) {
+			LOG_WRN("Skipped the unreadable setting %u.", entry.id);
+			return true;
+		}
+
+		add(entry.id, stored->name);
+		return true;
+	});
+}
+
+void settings_backend::register_backend()
+{
+	settings_src_register(&store.store);
+	settings_dst_register(&store.store);
+}
+
+util::error_code settings_backend::load(const struct settings_load_arg &arg)
+{
+	const std::string_view subtree = (arg.subtree != nullptr) ? arg.subtree : "";
+	const uint32_t subtree_hash = hash(subtree);
+	const uint32_t subtree_bits = filter_bits(subtree_hash);
+	const auto id_of = [](const auto &entry) { return entry.first; };
+
+	// the next entry is looked up by the ID of the current one, as the handlers may save
+	// settings and hence change the index
+	uint16_t current = 0U;
+	for (auto entry = index.begin(); entry != index.end();
+	     entry = std::ranges::upper_bound(index, current, {}, id_of)) {
+		const auto [id, hashes] = *entry;
+		current = id;
+		if (!subtree.empty() && (hashes.name != subtree_hash) &&
+		    ((hashes.parents & subtree_bits) != subtree_bits)) {
+			continue;
+		}
+
+		const auto stored = read(id, load_buffer);
+		if (!stored) {
+			LOG_WRN("Skipped the unreadable setting %u.", id);
+			continue;
+		}
+
+		// names that only share a hash with the subtree are skipped by the handler lookup
+		auto value = stored->value;
+		const auto result = settings_call_set_handler(stored->name.data(), value.size(),
+							      read_value, &value, &arg);
+		if (result != 0) {
+			return os::result_to_error_code(result);
+		}
+	}
+	return {};
+}
+
+util::error_code settings_backend::save(std::string_view name, std::span<const uint8_t> value)
+{
+	if (name.empty() || name.size() > SETTINGS_MAX_NAME_LEN ||
+	    value.size() > SETTINGS_MAX_VAL_LEN) {
+		return util::errc::invalid_argument;
+	}
+
+	const uint32_t name_hash = hash(name);
+	auto id = find(name, name_hash);
+	if (!id && id.error() != util::error_condition{util::errc::no_such_file_or_directory}) {
+		return id.error();
+	}
+
+	if (value.empty()) {
+		// deleting a setting that does not exist
+		if (!id) {
+			return {};
+		}
+		if (const auto error = storage.write(*id, std::span<const uint8_t>{})) {
+			return error;
+		}
+		remove(*id);
+		return {};
+	}
+
+	const bool is_new = !id;
+	if (is_new) {
+		id = free_id();
+		if (!id) {
+			return id.error();
+		}
+	}
+
+	std::ranges::copy(name, buffer.begin());
+	buffer[name.size()] = 0U;
+	std::ranges::copy(value, buffer.begin() + name.size() + 1U);
+	const auto record = std::span<const uint8_t>{buffer}.first(name.size() + 1U + value.size());
+	if (const auto error = storage.write(*id, record)) {
+		return error;
+	}
+
+	// the entries of a stored name stay the same
+	if (is_new) {
+		add(*id, name);
+	}
+	return {};
+}
+
+std::optional<settings_backend::setting> settings_backend::parse(std::span<const uint8_t> record)
+{
+	const auto terminator = std::ranges::find(record, uint8_t{0U});
+	if (terminator == record.end()) {
+		return std::nullopt;
+	}
+
+	const auto length = static_cast<size_t>(terminator - record.begin());
+	return setting{{reinterpret_cast<const char *>(record.data()), length},
+		       record.subspan(length + 1U)};
+}
+
+std::expected<settings_backend::setting, util::error_code>
+settings_backend::read(uint16_t id, std::span<uint8_t> record_buffer)
+{
+	const auto record = storage.read(id, record_buffer);
+	if (!record) {
+		return std::unexpected{record.error()};
+	}
+
+	const auto stored = parse(*record);
+	if (!stored) {
+		return std::unexpected{util::errc::bad_message};
+	}
+	return *stored;
+}
+
+std::expected<uint16_t, util::error_code> settings_backend::find(std::string_view name,
+								  uint32_t name_hash)
+{
+	// the names with the same hash are compared, to rule out collisions
+	const auto same_hash = std::ranges::equal_range(by_name, name_hash, {}, &name_entry::hash);
+	for (const auto &entry : same_hash) {
+		const auto stored = read(entry.id, buffer);
+		if (!stored) {
+			return std::unexpected{stored.error()};
+		}
+		if (stored->name == name) {
+			return entry.id;
+		}
+	}
+	return std::unexpected{util::errc::no_such_file_or_directory};
+}
+
+std::expected<uint16_t, util::error_code> settings_backend::free_id() const
+{
+	if (index.full()) {
+		return std::unexpected{util::errc::not_enough_memory};
+	}
+
+	// the first gap in the IDs of the index, which is sorted by ID
+	uint32_t id = first_id;
+	for (const auto &entry : index) {
+		if (entry.first != id) {
+			break;
+		}
+		++id;
+	}
+	return static_cast<uint16_t>(id);
+}
+
+void settings_backend::add(uint16_t id, std::string_view name)
+{
+	remove(id);
+
+	const uint32_t name_hash = hash(name);
+	(void)index.insert_or_assign(id, {name_hash, parents_filter(name)});
+	(void)by_name.insert(std::ranges::upper_bound(by_name, name_hash, {}, &name_entry::hash),
+			     name_entry{name_hash, id});
+}
+
+void settings_backend::remove(uint16_t id)
+{
+	const auto *const hashes = index.get(id);
+	if (hashes == nullptr) {
+		return;
+	}
+
+	const auto same_hash =
+		std::ranges::equal_range(by_name, hashes->name, {}, &name_entry::hash);
+	const auto entry = std::ranges::find(same_hash, id, &name_entry::id);
+	if (entry != same_hash.end()) {
+		(void)by_name.erase(entry);
+	}
+	(void)index.erase(id);
+}
+
+int settings_backend::load_settings(struct settings_store *store,
+				    const struct settings_load_arg *arg)
+{
+	auto &backend = *reinterpret_cast<registration *>(store)->backend;
+	const struct settings_load_arg all{};
+	return os::error_code_to_result(backend.load((arg != nullptr) ? *arg : all));
+}
+
+int settings_backend::save_setting(struct settings_store *store, const char *name,
+				   const char *value, size_t length)
+{
+	if (name == nullptr) {
+		return -EINVAL;
+	}
+
+	auto &backend = *reinterpret_cast<registration *>(store)->backend;
+	const auto data = (value != nullptr)
+				  ? std::span{reinterpret_cast<const uint8_t *>(value), length}
+				  : std::span<const uint8_t>{};
+	return os::error_code_to_result(backend.save(name, data));
+}
+
+} // namespace storage
+
+/**
+ * @brief Initialization of the custom backend, called by settings_subsys_init().
+ */
+int settings_backend_init(void)
+{
+	// the storage needs to be initialized by the application before the settings subsystem
+	static storage::settings_backend backend{shared_storage()};
+
+	if (const auto error = backend.init()) {
+		LOG_ERR("Unable to load the settings index: %s", error.message());
+		return os::error_code_to_result(error);
+	}
+	backend.register_backend();
+	return 0;
+}
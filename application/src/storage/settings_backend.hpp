@@ -0,0 +1,132 @@
+#ifndef STORAGE_SETTINGS_BACKEND_HPP
+#define STORAGE_SETTINGS_BACKEND_HPP
+
+#include <zephyr/settings/settings.h>
+#include "storage/non_volatile_storage.hpp"
+#include "util/small_map.hpp"
+#include "util/static_vector.hpp"
+#include "util/system_error.hpp"
+#include <array>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace storage
+{
+
+/**
+ * @brief Backend of the Zephyr settings subsystem on non_volatile_storage
+ *        (CONFIG_APP_SETTINGS_BACKEND).
+ *
+ * Every setting is a single record of its name, a null terminator and its value, with an ID
+ * from CONFIG_APP_SETTINGS_FIRST_ID on. The nvs backend of Zephyr reads all names from the flash
+ * for every load and save, to find the ones of a subtree or the record of a name. This backend
+ * builds an index in RAM when it is mounted instead: the ID of every setting with the hash of its
+ * name and a filter of the hashes of its parents (e.g. "a" and "a/b" for "a/b/c"), and the IDs
+ * sorted by the hashes of the names. A save looks the name up by its hash with a binary search
+ * and a load reads only the records whose name or parents match the hash of the subtree. The
+ * names in the records are compared to rule out hash collisions.
+ *
+ * The records are stored through the storage instance of the application (shared_storage()), so
+ * that the partition is not mounted twice. The settings subsystem serializes the calls of its
+ * backends, so the index is not locked.
+ */
+class settings_backend
+{
+public:
+	explicit settings_backend(non_volatile_storage &storage);
+
+	// the settings subsystem references the backend
+	settings_backend(const settings_backend &) = delete;
+	settings_backend &operator=(const settings_backend &) = delete;
+
+	/**
+	 * @brief Builds the index of the stored settings.
+	 *
+	 * The storage needs to be initialized (non_volatile_storage::init()) before.
+	 */
+	[[nodiscard]] util::error_code init();
+
+	/**
+	 * @brief Registers the backend as source and destination of the settings subsystem.
+	 */
+	void register_backend();
+
+	/**
+	 * @brief Loads the settings of the subtree of the argument (all settings without one) with
+	 *        settings_call_set_handler().
+	 *
+	 * The handlers may save and delete settings during the load.
+	 */
+	[[nodiscard]] util::error_code load(const struct settings_load_arg &arg);
+
+	/**
+	 * @brief Saves a setting or deletes it, if the value is empty.
+	 *
+	 * @return invalid_argument for names or values that are too long, not_enough_memory if
+	 *         there are already CONFIG_APP_SETTINGS_MAX_ENTRIES settings.
+	 */
+	[[nodiscard]] util::error_code save(std::string_view name, std::span<const uint8_t> value);
+
+	/**
+	 * @return Number of stored settings.
+	 */
+	[[nodiscard]] size_t size() const
+	{
+		return index.size();
+	}
+
+private:
+	struct name_hashes {
+		uint32_t name;
+		/// Two bits for the hash of each parent of the name.
+		uint32_t parents;
+	};
+
+	/// Entry of the index of the IDs by the hashes of the names.
+	struct name_entry {
+		uint32_t hash;
+		uint16_t id;
+	};
+
+	struct setting {
+		std::string_view name; ///< followed by the null terminator in the record
+		std::span<const uint8_t> value;
+	};
+
+	/// Store of the settings subsystem, which the callbacks get.
+	struct registration {
+		struct settings_store store;
+		settings_backend *backend;
+	};
+
+	/// Largest record: name, null terminator and value.
+	static constexpr size_t max_record_size = SETTINGS_MAX_NAME_LEN + 1U + SETTINGS_MAX_VAL_LEN;
+
+	[[nodiscard]] static std::optional<setting> parse(std::span<const uint8_t> record);
+	[[nodiscard]] std::expected<setting, util::error_code>
+	read(uint16_t id, std::span<uint8_t> record_buffer);
+	[[nodiscard]] std::expected<uint16_t, util::error_code> find(std::string_view name,
+								     uint32_t name_hash);
+	[[nodiscard]] std::expected<uint16_t, util::error_code> free_id() const;
+	void add(uint16_t id, std::string_view name);
+	void remove(uint16_t id);
+
+	static int load_settings(struct settings_store *store, const struct settings_load_arg *arg);
+	static int save_setting(struct settings_store *store, const char *name, const char *value,
+				size_t length);
+
+	registration store{};
+	non_volatile_storage &storage;
+	util::small_map<uint16_t, name_hashes, CONFIG_APP_SETTINGS_MAX_ENTRIES> index{};
+	util::static_vector<name_entry, CONFIG_APP_SETTINGS_MAX_ENTRIES> by_name{};
+	std::array<uint8_t, max_record_size> buffer;
+	/// Record of the loaded setting, which stays valid while the handlers save settings.
+	std::array<uint8_t, max_record_size> load_buffer;
+};
+
+} // namespace storage
+
+#endif /* STORAGE_SETTINGS_BACKEND_HPP */
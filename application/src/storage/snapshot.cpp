@@ -0,0 +1,171 @@
+#include "snapshot.hpp"
+#include <zephyr/sys/byteorder.h>
+#include "storage/storage_error.hpp"
+#include "util/crc32.hpp"
+#include <algorithm>
+#include <array>
+
+namespace storage::snapshot
+{
+
+namespace
+{
+constexpr std::array<uint8_t, 4> magic{'N', 'V', 'S', 'S'};
+constexpr size_t header_size = magic.size() + 2U * sizeof(uint16_t);
+constexpr size_t record_header_size = 2U * sizeof(uint16_t);
+} // namespace
+
+util::error_code encoder::begin()
+{
+	std::array<uint8_t, header_size> header{};
+	std::ranges::copy(magic, header.begin());
+	sys_put_le16(version, &header[magic.size()]);
+	return emit(header);
+}
+
+util::error_code encoder::add(uint16_t id, std::span<const uint8_t> data)
+{
+	// a length of 0 marks the end of the snapshot
+	if (data.empty() || data.size() > UINT16_MAX) {
+		return util::errc::invalid_argument;
+	}
+
+	std::array<uint8_t, record_header_size> header;
+	sys_put_le16(id, &header[0]);
+	sys_put_le16(static_cast<uint16_t>(data.size()), &header[sizeof(uint16_t)]);
+	if (const auto error = emit(header)) {
+		return error;
+	}
+	if (const auto error = emit(data)) {
+		return error;
+	}
+
+	++record_count;
+	return {};
+}
+
+util::error_code encoder::finish()
+{
+	std::array<uint8_t, record_header_size + sizeof(uint32_t)> end{};
+	sys_put_le32(record_count, &end[record_header_size]);
+	if (const auto error = emit(end)) {
+		return error;
+	}
+
+	// the CRC itself is not part of the CRC
+	std::array<uint8_t, sizeof(uint32_t)> checksum;
+	sys_put_le32(crc, checksum.data());
+	return output(checksum);
+}
+
+util::error_code encoder::emit(std::span<const uint8_t> data)
+{
+	crc = util::crc32::update(crc, data);
+	return output(data);
+}
+
+next_record decoder::next()
+{
+	if (finished) {
+		return std::nullopt;
+	}
+
+	if (!started) {
+		if (const auto error = begin()) {
+			return std::unexpected{error};
+		}
+		started = true;
+	}
+
+	std::array<uint8_t, record_header_size> header;
+	if (const auto error = take(header)) {
+		return std::unexpected{error};
+	}
+
+	const uint16_t id = sys_get_le16(&header[0]);
+	const uint16_t length = sys_get_le16(&header[sizeof(uint16_t)]);
+	if (length == 0U) {
+		// the end marker
+		const auto error = (id == 0U) ? finish() : storage_error_code::invalid_snapshot;
+		if (error) {
+			return std::unexpected{error};
+		}
+		return std::nullopt;
+	}
+
+	if (length > buffer.size()) {
+		return std::unexpected{util::errc::no_buffer_space};
+	}
+
+	const auto data = buffer.first(length);
+	if (const auto error = take(data)) {
+		return std::unexpected{error};
+	}
+
+	++record_count;
+	return record_entry{id, data.size(), data};
+}
+
+util::error_code decoder::take(std::span<uint8_t> data)
+{
+	if (const auto error = input(offset, data)) {
+		return error;
+	}
+
+	offset += data.size();
+	crc = util::crc32::update(crc, data);
+	return {};
+}
+
+util::error_code decoder::begin()
+{
+	std::array<uint8_t, header_size> header;
+	if (const auto error = take(header)) {
+		return error;
+	}
+
+	if (!std::ranges::equal(std::span{header}.first(magic.size()), magic)) {
+		return storage_error_code::invalid_snapshot;
+	}
+	if (sys_get_le16(&header[magic.size()]) != version) {
+		return storage_error_code::unsupported_snapshot_version;
+	}
+	return {};
+}
+
+util::error_code decoder::finish()
+{
+	std::array<uint8_t, sizeof(uint32_t)> count;
+	if (const auto error = take(count)) {
+		return error;
+	}
+
+	std::array<uint8_t, sizeof(uint32_t)> checksum;
+	if (const auto error = input(offset, checksum)) {
+		return error;
+	}
+
+	if (sys_get_le32(count.data()) != record_count ||
+	    sys_get_le32(checksum.data()) != crc) {
+		return storage_error_code::invalid_snapshot;
+	}
+
+	finished = true;
+	return {};
+}
+
+util::error_code verify(const source &input, std::span<uint8_t> buffer)
+{
+	decoder snapshot{input, buffer};
+	while (true) {
+		const auto record = snapshot.next();
+		if (!record) {
+			return record.error();
+		}
+		if (!record->has_value()) {
+			return {};
+		}
+	}
+}
+
+} // namespace storage::snapshot
@@ -0,0 +1,110 @@
+#ifndef STORAGE_SNAPSHOT_HPP
+#define STORAGE_SNAPSHOT_HPP
+
+#include "storage/backend.hpp"
+#include "util/inplace_function.hpp"
+#include "util/system_error.hpp"
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+
+/**
+ * @brief Versioned snapshot of all records of a storage, for exporting and restoring them.
+ *
+ * Layout (all numbers in little endian):
+ * - header: magic "NVSS", version (16 bit), reserved (16 bit, 0)
+ * - every record: ID (16 bit), length (16 bit, never 0), data
+ * - end: ID 0 and length 0, number of records (32 bit), CRC32 of all preceding bytes (32 bit)
+ *
+ * Snapshots are streamed in both directions, so that neither side needs memory for more than a
+ * single record. A restore reads the snapshot twice (first to check it completely, then to write
+ * it), so the source reads by offset.
+ */
+namespace storage::snapshot
+{
+
+constexpr uint16_t version = 1U;
+
+/// Takes the next part of a snapshot (e.g. sends it to a host).
+using sink = util::inplace_function<util::error_code(std::span<const uint8_t> data)>;
+
+/// Fills the buffer completely with the part of a snapshot at the offset (the same part for the
+/// same offset, on every call).
+using source = util::inplace_function<util::error_code(size_t offset, std::span<uint8_t> buffer)>;
+
+/**
+ * @brief Writes a snapshot into a sink, record by record.
+ */
+class encoder
+{
+public:
+	explicit encoder(sink output) : output{std::move(output)}
+	{
+	}
+
+	[[nodiscard]] util::error_code begin();
+
+	/**
+	 * @return invalid_argument for empty data (which is a deleted record) or the error of the
+	 *         sink.
+	 */
+	[[nodiscard]] util::error_code add(uint16_t id, std::span<const uint8_t> data);
+
+	[[nodiscard]] util::error_code finish();
+
+private:
+	util::error_code emit(std::span<const uint8_t> data);
+
+	sink output;
+	uint32_t crc = 0U;
+	uint32_t record_count = 0U;
+};
+
+/**
+ * @brief Reads a snapshot from a source, record by record.
+ */
+class decoder
+{
+public:
+	/**
+	 * @param buffer Buffer for the data of a single record (limits the size of the records).
+	 */
+	decoder(source input, std::span<uint8_t> buffer) : input{std::move(input)}, buffer{buffer}
+	{
+	}
+
+	/**
+	 * @brief Reads the next record.
+	 *
+	 * @return The record with its data in the buffer (valid until the next call), nothing
+	 *         after the last record of a complete snapshot, or invalid_snapshot,
+	 *         unsupported_snapshot_version, no_buffer_space or the error of the source.
+	 */
+	[[nodiscard]] next_record next();
+
+private:
+	util::error_code take(std::span<uint8_t> data);
+	util::error_code begin();
+	util::error_code finish();
+
+	source input;
+	std::span<uint8_t> buffer;
+	size_t offset = 0U;
+	uint32_t crc = 0U;
+	uint32_t record_count = 0U;
+	bool started = false;
+	bool finished = false;
+};
+
+/**
+ * @brief Reads a whole snapshot and checks it (format, version, record lengths, record count and
+ *        CRC), without restoring it.
+ *
+ * @param buffer Buffer for the data of a single record.
+ */
+[[nodiscard]] util::error_code verify(const source &input, std::span<uint8_t> buffer);
+
+} // namespace storage::snapshot
+
+#endif /* STORAGE_SNAPSHOT_HPP */
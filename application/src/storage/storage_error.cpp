@@ -0,0 +1,24 @@
+#include "storage_error.hpp"
+#include <array>
+
+namespace
+{
+constexpr std::array<util::error_message, 6> messages{{
+	{static_cast<int>(storage_error_code::device_not_ready), "Device is not ready"},
+	{static_cast<int>(storage_error_code::unable_to_get_page_info), "Unable to get page info"},
+	{static_cast<int>(storage_error_code::wrong_data_size), "Wrong data size"},
+	{static_cast<int>(storage_error_code::checksum_mismatch), "Checksum mismatch"},
+	{static_cast<int>(storage_error_code::invalid_snapshot), "Invalid snapshot"},
+	{static_cast<int>(storage_error_code::unsupported_snapshot_version),
+	 "Unsupported snapshot version"},
+}};
+static_assert(util::is_valid_message_table(messages));
+
+constinit const util::error_category the_error_category{"non_volatile_storage", messages};
+
+} // namespace
+
+util::error_code make_error_code(storage_error_code code)
+{
+	return {static_cast<int>(code), the_error_category};
+}
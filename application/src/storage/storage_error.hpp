@@ -0,0 +1,27 @@
+#ifndef STORAGE_STORAGE_ERROR_HPP
+#define STORAGE_STORAGE_ERROR_HPP
+
+#include "util/system_error.hpp"
+#include <cstdint>
+
+enum class storage_error_code : uint8_t {
+	device_not_ready = 1,
+	unable_to_get_page_info = 2,
+	wrong_data_size = 3,
+	checksum_mismatch = 4,
+	invalid_snapshot = 5,
+	unsupported_snapshot_version = 6,
+};
+
+util::error_code make_error_code(storage_error_code code);
+
+// the concrete error code type needs to be made known to the 'system_error'
+// implementation that resides in the 'util' namespace
+namespace util
+{
+template <>
+struct is_error_code_enum<storage_error_code> : public std::true_type {
+};
+} // namespace util
+
+#endif /* STORAGE_STORAGE_ERROR_HPP */
@@ -0,0 +1,363 @@
+#include "wear_governor.hpp"
+#include "storage/storage_error.hpp"
+#include <zephyr/logging/log.h>
+#include <algorithm>
+#include <cstring>
+
+LOG_MODULE_REGISTER(wear_governor);
+
+namespace storage
+{
+
+wear_governor::wear_governor()
+{
+	k_mutex_init(&lock);
+	k_mutex_init(&write_lock);
+}
+
+wear_governor::~wear_governor()
+{
+	// the deferred data would be lost otherwise
+	interval_task.stop();
+	if (const auto error = flush()) {
+		LOG_ERR("Deferred writes got lost: %s", error.message());
+	}
+}
+
+void wear_governor::start(storage_access access, flash_geometry geometry)
+{
+	this->access = access;
+	this->geometry = geometry;
+	interval_task.start(std::chrono::seconds{CONFIG_APP_STORAGE_WEAR_INTERVAL});
+}
+
+util::error_code wear_governor::write(uint16_t id, std::span<const uint8_t> data)
+{
+	if (access.write == nullptr) {
+		// same error as for writing to a file system that was not mounted
+		return util::errc::permission_denied;
+	}
+
+	// held until the data is written, so that neither a deferred write overtakes this write
+	// nor this write a newer one
+	k_mutex_lock(&write_lock, K_FOREVER);
+
+	// a deferred write of the ID must not be overtaken: the newer data replaces it, if it fits
+	k_mutex_lock(&lock, K_FOREVER);
+	const auto slot = std::ranges::find(deferred, id, &deferred_write::id);
+	if (slot != deferred.end()) {
+		if (data.size() <= slot->data.size()) {
+			std::ranges::copy(data, slot->data.begin());
+			slot->length = static_cast<uint16_t>(data.size());
+			totals.coalesced_writes++;
+			k_mutex_unlock(&lock);
+			k_mutex_unlock(&write_lock);
+			return {};
+		}
+		deferred.erase(slot);
+	}
+	k_mutex_unlock(&lock);
+
+	// compared without the lock, as the storage reads the deferred writes
+	util::error_code error{};
+	if (access.is_stored(access.storage, id, data)) {
+		k_mutex_lock(&lock, K_FOREVER);
+		totals.unchanged_writes++;
+		k_mutex_unlock(&lock);
+	} else {
+		k_mutex_lock(&lock, K_FOREVER);
+		const bool deferred_now = defer(id, data);
+		k_mutex_unlock(&lock);
+
+		if (!deferred_now) {
+			error = access.write(access.storage, id, data);
+		}
+	}
+
+	k_mutex_unlock(&write_lock);
+	return error;
+}
+
+std::optional<std::expected<std::span<uint8_t>, util::error_code>>
+wear_governor::read_deferred(uint16_t id, std::span<uint8_t> buffer)
+{
+	k_mutex_lock(&lock, K_FOREVER);
+	std::optional<std::expected<std::span<uint8_t>, util::error_code>> result;
+
+	const auto slot = std::ranges::find(deferred, id, &deferred_write::id);
+	if (slot == deferred.end()) {
+		// not deferred
+	} else if (slot->length == 0U) {
+		// same error as for reading a record that does not exist
+		result.emplace(std::unexpected{util::errc::no_such_file_or_directory});
+	} else if (slot->length > buffer.size()) {
+		result.emplace(std::unexpected{storage_error_code::wrong_data_size});
+	} else {
+		std::memcpy(buffer.data(), slot->data.data(), slot->length);
+		result.emplace(buffer.first(slot->length));
+	}
+
+	k_mutex_unlock(&lock);
+	return result;
+}
+
+std::optional<util::error_code>
+wear_governor::visit_deferred(uint16_t id, deferred_visitor visitor, void *context)
+{
+	k_mutex_lock(&lock, K_FOREVER);
+	std::optional<util::error_code> result;
+
+	const auto slot = std::ranges::find(deferred, id, &deferred_write::id);
+	if (slot == deferred.end()) {
+		// not deferred
+	} else if (slot->length == 0U) {
+		result.emplace(util::errc::no_such_file_or_directory);
+	} else {
+		result.emplace(visitor(context, std::span{slot->data}.first(slot->length)));
+	}
+
+	k_mutex_unlock(&lock);
+	return result;
+}
+
+util::error_code wear_governor::flush()
+{
+	return write_deferred(false);
+}
+
+std::expected<bool, util::error_code> wear_governor::flush(uint16_t id)
+{
+	if (access.write == nullptr) {
+		return true;
+	}
+
+	k_mutex_lock(&write_lock, K_FOREVER);
+	k_mutex_lock(&lock, K_FOREVER);
+	const auto slot = std::ranges::find(deferred, id, &deferred_write::id);
+	const bool up_to_date = (slot == deferred.end());
+	const bool within_budget = !up_to_date && is_within_budget(id, cost_of(slot->length));
+	k_mutex_unlock(&lock);
+
+	const auto error = within_budget ? write_slot(id) : util::error_code{};
+	k_mutex_unlock(&write_lock);
+
+	if (error) {
+		return std::unexpected{error};
+	}
+	return up_to_date || within_budget;
+}
+
+void wear_governor::discard()
+{
+	k_mutex_lock(&write_lock, K_FOREVER);
+	k_mutex_lock(&lock, K_FOREVER);
+	deferred.clear();
+	k_mutex_unlock(&lock);
+	k_mutex_unlock(&write_lock);
+}
+
+size_t wear_governor::pending() const
+{
+	k_mutex_lock(&lock, K_FOREVER);
+	const auto count = deferred.size();
+	k_mutex_unlock(&lock);
+	return count;
+}
+
+wear_statistics wear_governor::statistics() const
+{
+	k_mutex_lock(&lock, K_FOREVER);
+	auto statistics = totals;
+	statistics.interval_bytes = global_bytes;
+	k_mutex_unlock(&lock);
+
+	if (geometry.sector_size > 0U) {
+		statistics.sector_erases = statistics.bytes_programmed / geometry.sector_size;
+	}
+	return statistics;
+}
+
+std::optional<std::chrono::hours> wear_governor::projected_lifetime() const
+{
+	const auto statistics = this->statistics();
+	if (geometry.sector_size == 0U || statistics.bytes_programmed == 0U ||
+	    statistics.seconds == 0U) {
+		return std::nullopt;
+	}
+
+	const uint64_t endurance = static_cast<uint64_t>(geometry.sector_size) *
+				   geometry.sector_count * CONFIG_APP_STORAGE_WEAR_ERASE_CYCLES;
+	if (statistics.bytes_programmed >= endurance) {
+		return std::chrono::hours{0};
+	}
+
+	// the remaining bytes at the average rate of programmed bytes per second
+	const uint64_t remaining_seconds = (endurance - statistics.bytes_programmed) *
+					   statistics.seconds / statistics.bytes_programmed;
+	return std::chrono::duration_cast<std::chrono::hours>(
+		std::chrono::seconds{remaining_seconds});
+}
+
+void wear_governor::interval_handler(void *context)
+{
+	static_cast<wear_governor *>(context)->next_interval();
+}
+
+void wear_governor::next_interval()
+{
+	// restored here, as the storage may still be mounting when the governor gets started
+	if (!restored) {
+		restore();
+		restored = true;
+	}
+
+	k_mutex_lock(&lock, K_FOREVER);
+	id_bytes.clear();
+	global_bytes = 0U;
+	totals.seconds += CONFIG_APP_STORAGE_WEAR_INTERVAL;
+	k_mutex_unlock(&lock);
+
+	if (const auto error = write_deferred(true)) {
+		LOG_ERR("Writing of deferred data failed: %s", error.message());
+	}
+
+	if (++intervals_since_persist >= CONFIG_APP_STORAGE_WEAR_PERSIST_INTERVALS &&
+	    statistics().bytes_programmed != persisted_bytes) {
+		persist();
+		intervals_since_persist = 0U;
+	}
+}
+
+util::error_code wear_governor::write_deferred(bool within_budget)
+{
+	if (access.write == nullptr) {
+		return {};
+	}
+
+	for (;;) {
+		// the write lock is taken per record, so that writers of other IDs are not blocked
+		// by all deferred writes
+		k_mutex_lock(&write_lock, K_FOREVER);
+		k_mutex_lock(&lock, K_FOREVER);
+		const auto slot = std::ranges::find_if(deferred, [this, within_budget](auto &next) {
+			return !within_budget || is_within_budget(next.id, cost_of(next.length));
+		});
+		const bool found = (slot != deferred.end());
+		const uint16_t id = found ? slot->id : 0U;
+		k_mutex_unlock(&lock);
+
+		const auto error = found ? write_slot(id) : util::error_code{};
+		k_mutex_unlock(&write_lock);
+
+		if (!found || error) {
+			return error;
+		}
+	}
+}
+
+util::error_code wear_governor::write_slot(uint16_t id)
+{
+	// the data is written without holding the lock, so that readers are not blocked by the
+	// flash access
+	k_mutex_lock(&lock, K_FOREVER);
+	const auto slot = std::ranges::find(deferred, id, &deferred_write::id);
+	if (slot == deferred.end()) {
+		k_mutex_unlock(&lock);
+		return {};
+	}
+	const deferred_write entry = *slot;
+	account(entry.id, cost_of(entry.length));
+	k_mutex_unlock(&lock);
+
+	const auto error = access.write(access.storage, entry.id,
+					std::span{entry.data}.first(entry.length));
+	if (!error) {
+		k_mutex_lock(&lock, K_FOREVER);
+		deferred.erase(std::ranges::find(deferred, id, &deferred_write::id));
+		k_mutex_unlock(&lock);
+	}
+	return error;
+}
+
+void wear_governor::restore()
+{
+	persistent_accounting accounting{};
+	const auto data = access.read(
+		access.storage, CONFIG_APP_STORAGE_WEAR_RECORD_ID,
+		std::span{reinterpret_cast<uint8_t *>(&accounting), sizeof(accounting)});
+	if (!data || data->size() != sizeof(accounting)) {
+		return; // first start
+	}
+
+	k_mutex_lock(&lock, K_FOREVER);
+	totals.bytes_programmed += accounting.bytes_programmed;
+	totals.seconds += accounting.seconds;
+	persisted_bytes = accounting.bytes_programmed;
+	k_mutex_unlock(&lock);
+}
+
+void wear_governor::persist()
+{
+	k_mutex_lock(&lock, K_FOREVER);
+	const size_t cost = cost_of(sizeof(persistent_accounting));
+	account(CONFIG_APP_STORAGE_WEAR_RECORD_ID, cost);
+	const persistent_accounting accounting{totals.bytes_programmed, totals.seconds};
+	k_mutex_unlock(&lock);
+
+	const auto error = access.write(
+		access.storage, CONFIG_APP_STORAGE_WEAR_RECORD_ID,
+		std::span{reinterpret_cast<const uint8_t *>(&accounting), sizeof(accounting)});
+	if (error) {
+		LOG_WRN("Persisting of the wear accounting failed: %s", error.message());
+		return;
+	}
+	persisted_bytes = accounting.bytes_programmed;
+}
+
+bool wear_governor::defer(uint16_t id, std::span<const uint8_t> data)
+{
+	const auto cost = cost_of(data.size());
+	if (!is_within_budget(id, cost)) {
+		if (data.size() <= CONFIG_APP_STORAGE_WEAR_MAX_DEFERRED_SIZE && !deferred.full()) {
+			auto *const entry = deferred.emplace_back();
+			entry->id = id;
+			entry->length = static_cast<uint16_t>(data.size());
+			std::ranges::copy(data, entry->data.begin());
+			totals.deferred_writes++;
+			return true;
+		}
+
+		LOG_DBG("Write of ID %u exceeds the budget, but can not be deferred.", id);
+		totals.forced_writes++;
+	}
+
+	account(id, cost);
+	return false;
+}
+
+bool wear_governor::is_within_budget(uint16_t id, size_t cost)
+{
+	// the first write of an ID in an interval is always within its budget, so that records that
+	// are larger than the budget do not get deferred forever
+	const auto *const used = id_bytes.get(id);
+	const bool id_budget = (used == nullptr) || (*used == 0U) ||
+			       (*used + cost <= CONFIG_APP_STORAGE_WEAR_ID_BUDGET);
+	const bool global_budget = (global_bytes == 0U) ||
+				   (global_bytes + cost <= CONFIG_APP_STORAGE_WEAR_GLOBAL_BUDGET);
+	return id_budget && global_budget;
+}
+
+void wear_governor::account(uint16_t id, size_t cost)
+{
+	global_bytes += cost;
+	totals.bytes_programmed += cost;
+
+	// IDs that can not be tracked in this interval anymore are limited by the global budget
+	if (auto *const used = id_bytes.get(id)) {
+		*used += cost;
+	} else {
+		(void)id_bytes.insert_or_assign(id, cost);
+	}
+}
+
+} // namespace storage
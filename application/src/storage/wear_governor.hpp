@@ -0,0 +1,200 @@
+#ifndef STORAGE_WEAR_GOVERNOR_HPP
+#define STORAGE_WEAR_GOVERNOR_HPP
+
+#include <zephyr/kernel.h>
+#include "os/periodic_task.hpp"
+#include "storage/backend.hpp"
+#include "util/small_map.hpp"
+#include "util/static_vector.hpp"
+#include "util/system_error.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+
+namespace storage
+{
+
+/**
+ * @brief Accounting of the flash wear.
+ */
+struct wear_statistics {
+	uint64_t bytes_programmed; ///< including the record overhead, since the first start
+	uint64_t seconds;          ///< accounted operating time, since the first start
+	uint64_t sector_erases;    ///< estimated from the programmed bytes (0 without geometry)
+	uint32_t interval_bytes;   ///< programmed in the current interval
+	uint32_t deferred_writes;  ///< writes over the budget that were deferred (since boot)
+	uint32_t coalesced_writes; ///< writes that replaced a deferred write (since boot)
+	uint32_t forced_writes;    ///< writes over the budget that were not deferred (since boot)
+	uint32_t unchanged_writes; ///< writes of the data that was stored already (since boot)
+};
+
+/**
+ * @brief Write budgets per record ID and for the whole storage, against wearing out the flash.
+ *
+ * The bytes that get programmed are accounted per interval (CONFIG_APP_STORAGE_WEAR_INTERVAL).
+ * Writes that exceed the budget of their ID (CONFIG_APP_STORAGE_WEAR_ID_BUDGET) or the global
+ * budget (CONFIG_APP_STORAGE_WEAR_GLOBAL_BUDGET) do not fail: they are kept in RAM and written in
+ * a later interval. Until then, further writes of the same ID replace the deferred data, so that
+ * a module that writes an ID in a loop only programs the flash once per interval. Reads return
+ * the deferred data.
+ *
+ * Writes that can neither be deferred (too large or no slot left) are written anyway and counted
+ * as forced. Writes of the data that is already stored are neither accounted nor written, as the
+ * backends do not program the flash for them. The writes of the governor and of the writers are
+ * serialized, so that the data of an ID is stored in the order of the writes.
+ *
+ * The accounting is persisted in its own record every CONFIG_APP_STORAGE_WEAR_PERSIST_INTERVALS
+ * intervals, to project the lifetime of the flash. The budgets, the deferred writes and the
+ * persisted record belong to one governor: the storage partition needs to be written through a
+ * single storage instance (with its governor), as further instances would get their own budgets
+ * and would overwrite the persisted accounting of each other.
+ */
+class wear_governor
+{
+public:
+	/// Access to the storage, which bypasses the governor.
+	struct storage_access {
+		void *storage;
+		util::error_code (*write)(void *storage, uint16_t id,
+					  std::span<const uint8_t> data);
+		std::expected<std::span<uint8_t>, util::error_code> (*read)(
+			void *storage, uint16_t id, std::span<uint8_t> buffer);
+		bool (*is_stored)(void *storage, uint16_t id, std::span<const uint8_t> data);
+	};
+
+	using deferred_visitor = util::error_code (*)(void *context, std::span<const uint8_t> data);
+
+	wear_governor();
+	~wear_governor();
+
+	// the governor is referenced by its periodic task and can hence not be copied or moved
+	wear_governor(const wear_governor &) = delete;
+	wear_governor &operator=(const wear_governor &) = delete;
+
+	/**
+	 * @brief Starts the accounting intervals.
+	 *
+	 * @param geometry The sectors of the storage for projecting the lifetime, or an empty
+	 *                 geometry, if they are not known.
+	 */
+	void start(storage_access access, flash_geometry geometry);
+
+	/**
+	 * @brief Writes the data now (and accounts it) or defers it, if it exceeds the budget.
+	 */
+	[[nodiscard]] util::error_code write(uint16_t id, std::span<const uint8_t> data);
+
+	/**
+	 * @brief Copies the deferred data of the ID into the buffer.
+	 *
+	 * @return Nothing, if no write of the ID is deferred. Otherwise the data or an error, if
+	 *         the deferred write deletes the record or the buffer is too small.
+	 */
+	[[nodiscard]] std::optional<std::expected<std::span<uint8_t>, util::error_code>>
+	read_deferred(uint16_t id, std::span<uint8_t> buffer);
+
+	/**
+	 * @brief Passes the deferred data of the ID to the visitor without copying it.
+	 *
+	 * The visitor is called with the lock of the governor held and must not access the
+	 * storage.
+	 *
+	 * @return Nothing, if no write of the ID is deferred. Otherwise the result of the visitor
+	 *         or an error, if the deferred write deletes the record.
+	 */
+	[[nodiscard]] std::optional<util::error_code>
+	visit_deferred(uint16_t id, deferred_visitor visitor, void *context);
+
+	/**
+	 * @brief Writes all deferred data now, regardless of the budgets.
+	 */
+	[[nodiscard]] util::error_code flush();
+
+	/**
+	 * @brief Writes the deferred data of the ID now, if it is within the budget.
+	 *
+	 * @return Whether the stored record is up to date (also if nothing was deferred), or the
+	 *         error of the write.
+	 */
+	[[nodiscard]] std::expected<bool, util::error_code> flush(uint16_t id);
+
+	/**
+	 * @brief Drops all deferred writes (e.g. as the storage gets cleared).
+	 *
+	 * Waits for a deferred write that is being written, so that it is not written afterwards.
+	 */
+	void discard();
+
+	/**
+	 * @brief Number of deferred writes that still need to be written.
+	 */
+	[[nodiscard]] size_t pending() const;
+
+	[[nodiscard]] wear_statistics statistics() const;
+
+	/**
+	 * @brief Projection of the remaining lifetime of the flash at the average wear so far.
+	 *
+	 * Every sector is expected to be erased once per sector size of programmed bytes (as the
+	 * backends write the sectors sequentially), so that the lifetime is reached after
+	 * CONFIG_APP_STORAGE_WEAR_ERASE_CYCLES times the size of all sectors.
+	 *
+	 * @return Nothing, if the geometry is unknown or nothing was accounted yet.
+	 */
+	[[nodiscard]] std::optional<std::chrono::hours> projected_lifetime() const;
+
+private:
+	static void interval_handler(void *context);
+	void next_interval();
+	util::error_code write_deferred(bool within_budget);
+	void restore();
+	void persist();
+
+	// needs to be called with the write lock held, which keeps the deferred writes unchanged
+	util::error_code write_slot(uint16_t id);
+
+	// the following functions need to be called with the lock held
+	bool defer(uint16_t id, std::span<const uint8_t> data);
+	bool is_within_budget(uint16_t id, size_t cost);
+	void account(uint16_t id, size_t cost);
+
+	static constexpr size_t cost_of(size_t size)
+	{
+		return size + CONFIG_APP_STORAGE_WEAR_RECORD_OVERHEAD;
+	}
+
+	struct deferred_write {
+		uint16_t id;
+		uint16_t length; ///< 0 deletes the record
+		std::array<uint8_t, CONFIG_APP_STORAGE_WEAR_MAX_DEFERRED_SIZE> data;
+	};
+
+	/// Accounting that is persisted.
+	struct persistent_accounting {
+		uint64_t bytes_programmed;
+		uint64_t seconds;
+	};
+
+	storage_access access{};
+	flash_geometry geometry{};
+	mutable struct k_mutex lock;
+	struct k_mutex write_lock; ///< held from the decision on a write until it is written
+
+	util::static_vector<deferred_write, CONFIG_APP_STORAGE_WEAR_MAX_DEFERRED> deferred{};
+	util::small_map<uint16_t, uint32_t, CONFIG_APP_STORAGE_WEAR_TRACKED_IDS> id_bytes{};
+	uint32_t global_bytes = 0U; ///< programmed in the current interval
+
+	wear_statistics totals{};
+	uint64_t persisted_bytes = 0U;
+	uint32_t intervals_since_persist = 0U;
+	bool restored = false;
+
+	os::periodic_task interval_task{interval_handler, this};
+};
+
+} // namespace storage
+
+#endif /* STORAGE_WEAR_GOVERNOR_HPP */
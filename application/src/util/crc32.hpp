@@ -0,0 +1,112 @@
+#ifndef UTIL_CRC32_HPP
+#define UTIL_CRC32_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace util
+{
+
+/**
+ * @brief CRC-32 (IEEE 802.3, as used by zlib and Ethernet) with tables generated at compile time.
+ *
+ * Two variants are provided: the classic table-driven one that processes one byte per lookup
+ * (1 KiB of tables) and slice-by-8 that processes eight bytes per iteration (8 KiB of tables).
+ */
+namespace crc32
+{
+
+namespace detail
+{
+constexpr uint32_t polynomial = 0xEDB88320U; // reversed representation of 0x04C11DB7
+
+using table = std::array<uint32_t, 256>;
+
+template <size_t count> constexpr std::array<table, count> make_tables()
+{
+	std::array<table, count> tables{};
+
+	for (uint32_t i = 0; i < 256U; ++i) {
+		uint32_t crc = i;
+		for (int bit = 0; bit < 8; ++bit) {
+			crc = (crc & 1U) ? (crc >> 1) ^ polynomial : crc >> 1;
+		}
+		tables[0][i] = crc;
+	}
+
+	// table n gives the CRC of a byte followed by n zero bytes
+	for (size_t n = 1; n < tables.size(); ++n) {
+		for (size_t i = 0; i < 256U; ++i) {
+			const auto previous = tables[n - 1][i];
+			tables[n][i] = (previous >> 8) ^ tables[0][previous & 0xFFU];
+		}
+	}
+
+	return tables;
+}
+
+// separate objects, so that only the tables of the used variant end up in flash
+inline constexpr auto byte_table = make_tables<1>()[0];
+inline constexpr auto slice_tables = make_tables<8>();
+
+constexpr uint32_t update_bytewise(uint32_t crc, std::span<const uint8_t> data,
+				   const table &lookup)
+{
+	for (const auto byte : data) {
+		crc = (crc >> 8) ^ lookup[(crc ^ byte) & 0xFFU];
+	}
+	return crc;
+}
+
+} // namespace detail
+
+/**
+ * @brief Table-driven calculation, one byte per table lookup.
+ */
+constexpr uint32_t calculate(std::span<const uint8_t> data)
+{
+	return ~detail::update_bytewise(~0U, data, detail::byte_table);
+}
+
+/**
+ * @brief Table-driven calculation that continues over the next part of the data.
+ *
+ * @param crc The CRC of all preceding parts (0 for the first part).
+ */
+constexpr uint32_t update(uint32_t crc, std::span<const uint8_t> data)
+{
+	return ~detail::update_bytewise(~crc, data, detail::byte_table);
+}
+
+/**
+ * @brief Slice-by-8 calculation, eight bytes per iteration with eight independent lookups.
+ */
+constexpr uint32_t calculate_slice_by_8(std::span<const uint8_t> data)
+{
+	constexpr const auto &tables = detail::slice_tables;
+
+	uint32_t crc = ~0U;
+	size_t i = 0;
+	for (; i + 8U <= data.size(); i += 8U) {
+		// assembled bytewise, so that neither alignment nor endianness of the data matter
+		const uint32_t low = crc ^ (data[i] | (data[i + 1] << 8) | (data[i + 2] << 16) |
+					    (static_cast<uint32_t>(data[i + 3]) << 24));
+		const uint32_t high = data[i + 4] | (data[i + 5] << 8) | (data[i + 6] << 16) |
+				      (static_cast<uint32_t>(data[i + 7]) << 24);
+
+		crc = tables[7][low & 0xFFU] ^ tables[6][(low >> 8) & 0xFFU] ^
+		      tables[5][(low >> 16) & 0xFFU] ^ tables[4][low >> 24] ^
+		      tables[3][high & 0xFFU] ^ tables[2][(high >> 8) & 0xFFU] ^
+		      tables[1][(high >> 16) & 0xFFU] ^ tables[0][high >> 24];
+	}
+
+	return ~detail::update_bytewise(crc, data.subspan(i), tables[0]);
+}
+
+} // namespace crc32
+
+} // namespace util
+
+#endif /* UTIL_CRC32_HPP */
@@ -0,0 +1,150 @@
+#ifndef UTIL_INPLACE_FUNCTION_HPP
+#define UTIL_INPLACE_FUNCTION_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace util
+{
+
+template <typename signature, size_t storage_size = 2U * sizeof(void *)>
+class inplace_function;
+
+/**
+ * @brief Callable wrapper like std::function, but the callable is stored within the object.
+ *
+ * Callables that do not fit into the storage are rejected at compile time instead of being
+ * allocated on the heap. The default storage fits two pointers, e.g. a lambda that captures two
+ * references. Calling an empty function is undefined.
+ */
+template <typename result_type, typename... argument_types, size_t storage_size>
+class inplace_function<result_type(argument_types...), storage_size>
+{
+public:
+	inplace_function() noexcept = default;
+
+	inplace_function(std::nullptr_t) noexcept
+	{
+	}
+
+	template <typename function_type>
+		requires(!std::is_same_v<std::remove_cvref_t<function_type>, inplace_function> &&
+			 std::is_invocable_r_v<result_type, std::decay_t<function_type> &,
+					       argument_types...>)
+	inplace_function(function_type &&function)
+	{
+		using stored_type = std::decay_t<function_type>;
+		static_assert(sizeof(stored_type) <= storage_size,
+			      "the callable does not fit into the storage of the function");
+		static_assert(alignof(stored_type) <= alignof(std::max_align_t),
+			      "the callable is over-aligned");
+		static_assert(std::is_copy_constructible_v<stored_type>,
+			      "the callable must be copyable");
+
+		::new (static_cast<void *>(storage))
+			stored_type(std::forward<function_type>(function));
+		operations = &operations_of<stored_type>;
+	}
+
+	inplace_function(const inplace_function &other) : operations(other.operations)
+	{
+		if (operations != nullptr) {
+			operations->copy(other.storage, storage);
+		}
+	}
+
+	inplace_function(inplace_function &&other) noexcept : operations(other.operations)
+	{
+		if (operations != nullptr) {
+			operations->move(other.storage, storage);
+			other.reset();
+		}
+	}
+
+	inplace_function &operator=(const inplace_function &other)
+	{
+		if (this != &other) {
+			reset();
+			if (other.operations != nullptr) {
+				other.operations->copy(other.storage, storage);
+				operations = other.operations;
+			}
+		}
+		return *this;
+	}
+
+	inplace_function &operator=(inplace_function &&other) noexcept
+	{
+		if (this != &other) {
+			reset();
+			if (other.operations != nullptr) {
+				other.operations->move(other.storage, storage);
+				operations = other.operations;
+				other.reset();
+			}
+		}
+		return *this;
+	}
+
+	~inplace_function()
+	{
+		reset();
+	}
+
+	explicit operator bool() const noexcept
+	{
+		return operations != nullptr;
+	}
+
+	result_type operator()(argument_types... arguments) const
+	{
+		return operations->invoke(storage, std::forward<argument_types>(arguments)...);
+	}
+
+	void reset() noexcept
+	{
+		if (operations != nullptr) {
+			operations->destroy(storage);
+			operations = nullptr;
+		}
+	}
+
+private:
+	/// Type-erased operations of the stored callable, one constant table per callable type.
+	struct operations_table {
+		result_type (*invoke)(void *callable, argument_types &&...arguments);
+		void (*copy)(const void *source, void *destination);
+		void (*move)(void *source, void *destination) noexcept;
+		void (*destroy)(void *callable) noexcept;
+	};
+
+	template <typename stored_type>
+	static constexpr operations_table operations_of{
+		.invoke = [](void *callable, argument_types &&...arguments) -> result_type {
+			return std::invoke(*static_cast<stored_type *>(callable),
+					   std::forward<argument_types>(arguments)...);
+		},
+		.copy = [](const void *source, void *destination) {
+			::new (destination) stored_type(*static_cast<const stored_type *>(source));
+		},
+		.move = [](void *source, void *destination) noexcept {
+			auto &callable = *static_cast<stored_type *>(source);
+			::new (destination) stored_type(std::move(callable));
+		},
+		.destroy = [](void *callable) noexcept {
+			std::destroy_at(static_cast<stored_type *>(callable));
+		},
+	};
+
+	// calling a const function may change the state of the callable (like with std::function)
+	alignas(std::max_align_t) mutable std::byte storage[storage_size];
+	const operations_table *operations = nullptr;
+};
+
+} // namespace util
+
+#endif /* UTIL_INPLACE_FUNCTION_HPP */
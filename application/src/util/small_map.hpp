@@ -0,0 +1,152 @@
+#ifndef UTIL_SMALL_MAP_HPP
+#define UTIL_SMALL_MAP_HPP
+
+#include "util/static_vector.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+namespace util
+{
+
+/**
+ * @brief Map with a fixed capacity for lookups by small keys (e.g. record IDs), without dynamic
+ *        memory.
+ *
+ * The entries are kept sorted by key in a static_vector: lookups are binary searches over
+ * contiguous memory, inserting and erasing move the following entries. This is faster than a
+ * node-based map for the few dozen entries it is meant for. All operations are constexpr.
+ */
+template <typename key_type, typename mapped_type, size_t capacity_,
+	  typename compare_type = std::less<key_type>>
+class small_map
+{
+public:
+	using value_type = std::pair<key_type, mapped_type>;
+	using iterator = typename static_vector<value_type, capacity_>::iterator;
+	using const_iterator = typename static_vector<value_type, capacity_>::const_iterator;
+
+	[[nodiscard]] static constexpr size_t capacity() noexcept
+	{
+		return capacity_;
+	}
+
+	[[nodiscard]] constexpr size_t size() const noexcept
+	{
+		return entries.size();
+	}
+
+	[[nodiscard]] constexpr bool empty() const noexcept
+	{
+		return entries.empty();
+	}
+
+	[[nodiscard]] constexpr bool full() const noexcept
+	{
+		return entries.full();
+	}
+
+	/// Iteration in the order of the keys.
+	constexpr iterator begin() noexcept
+	{
+		return entries.begin();
+	}
+
+	constexpr const_iterator begin() const noexcept
+	{
+		return entries.begin();
+	}
+
+	constexpr iterator end() noexcept
+	{
+		return entries.end();
+	}
+
+	constexpr const_iterator end() const noexcept
+	{
+		return entries.end();
+	}
+
+	/**
+	 * @return The entry of the key or end(), if there is none.
+	 */
+	constexpr iterator find(const key_type &key)
+	{
+		const auto position = lower_bound(key);
+		return (position != end() && !compare(key, position->first)) ? position : end();
+	}
+
+	constexpr const_iterator find(const key_type &key) const
+	{
+		return const_cast<small_map *>(this)->find(key);
+	}
+
+	[[nodiscard]] constexpr bool contains(const key_type &key) const
+	{
+		return find(key) != end();
+	}
+
+	/**
+	 * @return The value of the key or nullptr, if there is none.
+	 */
+	constexpr mapped_type *get(const key_type &key)
+	{
+		const auto position = find(key);
+		return (position != end()) ? &position->second : nullptr;
+	}
+
+	constexpr const mapped_type *get(const key_type &key) const
+	{
+		return const_cast<small_map *>(this)->get(key);
+	}
+
+	/**
+	 * @brief Inserts the value or assigns it, if the key already exists.
+	 *
+	 * @return The entry or end(), if the key is new and the map is full.
+	 */
+	constexpr iterator insert_or_assign(const key_type &key, mapped_type value)
+	{
+		const auto position = lower_bound(key);
+		if (position != end() && !compare(key, position->first)) {
+			position->second = std::move(value);
+			return position;
+		}
+		return entries.insert(position, value_type{key, std::move(value)});
+	}
+
+	/**
+	 * @return Whether an entry with the key was removed.
+	 */
+	constexpr bool erase(const key_type &key)
+	{
+		const auto position = find(key);
+		if (position == end()) {
+			return false;
+		}
+		entries.erase(position);
+		return true;
+	}
+
+	constexpr void clear() noexcept
+	{
+		entries.clear();
+	}
+
+private:
+	constexpr iterator lower_bound(const key_type &key)
+	{
+		return std::lower_bound(entries.begin(), entries.end(), key,
+					[this](const value_type &entry, const key_type &value) {
+						return compare(entry.first, value);
+					});
+	}
+
+	static_vector<value_type, capacity_> entries;
+	[[no_unique_address]] compare_type compare{};
+};
+
+} // namespace util
+
+#endif /* UTIL_SMALL_MAP_HPP */
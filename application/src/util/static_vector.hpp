@@ -0,0 +1,260 @@
+#ifndef UTIL_STATIC_VECTOR_HPP
+#define UTIL_STATIC_VECTOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace util
+{
+
+/**
+ * @brief Vector with a fixed capacity and inline storage (no dynamic memory).
+ *
+ * The elements are only constructed when they are added, so that the element type does not need
+ * to be default constructible. All operations are constexpr. Adding to a full vector does not
+ * change it and is reported by the return value (false, nullptr or end()) instead. As a contiguous
+ * range, it converts to std::span.
+ */
+template <typename T, size_t capacity_>
+class static_vector
+{
+	static_assert(capacity_ > 0U, "the capacity must not be zero");
+
+public:
+	using value_type = T;
+	using size_type = size_t;
+	using reference = T &;
+	using const_reference = const T &;
+	using iterator = T *;
+	using const_iterator = const T *;
+
+	constexpr static_vector() noexcept
+	{
+	}
+
+	constexpr static_vector(std::initializer_list<T> values)
+	{
+		for (const auto &value : values) {
+			if (!push_back(value)) {
+				break;
+			}
+		}
+	}
+
+	constexpr static_vector(const static_vector &other)
+	{
+		for (const auto &value : other) {
+			std::construct_at(&elements[count++], value);
+		}
+	}
+
+	constexpr static_vector(static_vector &&other) noexcept(
+		std::is_nothrow_move_constructible_v<T>)
+	{
+		for (auto &value : other) {
+			std::construct_at(&elements[count++], std::move(value));
+		}
+		other.clear();
+	}
+
+	constexpr static_vector &operator=(const static_vector &other)
+	{
+		if (this != &other) {
+			clear();
+			for (const auto &value : other) {
+				std::construct_at(&elements[count++], value);
+			}
+		}
+		return *this;
+	}
+
+	constexpr static_vector &operator=(static_vector &&other) noexcept(
+		std::is_nothrow_move_constructible_v<T>)
+	{
+		if (this != &other) {
+			clear();
+			for (auto &value : other) {
+				std::construct_at(&elements[count++], std::move(value));
+			}
+			other.clear();
+		}
+		return *this;
+	}
+
+	constexpr ~static_vector()
+		requires std::is_trivially_destructible_v<T>
+	= default;
+
+	constexpr ~static_vector()
+	{
+		clear();
+	}
+
+	[[nodiscard]] static constexpr size_t capacity() noexcept
+	{
+		return capacity_;
+	}
+
+	[[nodiscard]] constexpr size_t size() const noexcept
+	{
+		return count;
+	}
+
+	[[nodiscard]] constexpr bool empty() const noexcept
+	{
+		return count == 0U;
+	}
+
+	[[nodiscard]] constexpr bool full() const noexcept
+	{
+		return count == capacity_;
+	}
+
+	constexpr T *data() noexcept
+	{
+		return elements;
+	}
+
+	constexpr const T *data() const noexcept
+	{
+		return elements;
+	}
+
+	constexpr iterator begin() noexcept
+	{
+		return elements;
+	}
+
+	constexpr const_iterator begin() const noexcept
+	{
+		return elements;
+	}
+
+	constexpr iterator end() noexcept
+	{
+		return elements + count;
+	}
+
+	constexpr const_iterator end() const noexcept
+	{
+		return elements + count;
+	}
+
+	constexpr T &operator[](size_t index) noexcept
+	{
+		return elements[index];
+	}
+
+	constexpr const T &operator[](size_t index) const noexcept
+	{
+		return elements[index];
+	}
+
+	constexpr T &front() noexcept
+	{
+		return elements[0];
+	}
+
+	constexpr const T &front() const noexcept
+	{
+		return elements[0];
+	}
+
+	constexpr T &back() noexcept
+	{
+		return elements[count - 1U];
+	}
+
+	constexpr const T &back() const noexcept
+	{
+		return elements[count - 1U];
+	}
+
+	/**
+	 * @brief Constructs an element at the end.
+	 *
+	 * @return The new element or nullptr, if the vector is full.
+	 */
+	template <typename... argument_types>
+	constexpr T *emplace_back(argument_types &&...arguments)
+	{
+		if (full()) {
+			return nullptr;
+		}
+		return std::construct_at(&elements[count++],
+					 std::forward<argument_types>(arguments)...);
+	}
+
+	/**
+	 * @return Whether the element was added (false, if the vector is full).
+	 */
+	constexpr bool push_back(const T &value)
+	{
+		return emplace_back(value) != nullptr;
+	}
+
+	constexpr bool push_back(T &&value)
+	{
+		return emplace_back(std::move(value)) != nullptr;
+	}
+
+	constexpr void pop_back() noexcept
+	{
+		std::destroy_at(&elements[--count]);
+	}
+
+	/**
+	 * @brief Inserts an element before the position and moves the following elements back.
+	 *
+	 * @return The inserted element or end(), if the vector is full.
+	 */
+	constexpr iterator insert(const_iterator position, T value)
+	{
+		const auto index = static_cast<size_t>(position - begin());
+		if (!push_back(std::move(value))) {
+			return end();
+		}
+		std::rotate(begin() + index, end() - 1, end());
+		return begin() + index;
+	}
+
+	/**
+	 * @brief Removes an element and moves the following elements forward.
+	 *
+	 * @return The element that followed the removed one.
+	 */
+	constexpr iterator erase(const_iterator position)
+	{
+		const auto index = static_cast<size_t>(position - begin());
+		std::move(begin() + index + 1, end(), begin() + index);
+		pop_back();
+		return begin() + index;
+	}
+
+	constexpr void clear() noexcept
+	{
+		while (count > 0U) {
+			pop_back();
+		}
+	}
+
+	friend constexpr bool operator==(const static_vector &lhs, const static_vector &rhs)
+	{
+		return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+
+private:
+	// a union member is not initialized, so that the elements are only constructed when added
+	union {
+		T elements[capacity_];
+	};
+	size_t count = 0U;
+};
+
+} // namespace util
+
+#endif /* UTIL_STATIC_VECTOR_HPP */
@@ -10,6 +10,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "system_error.hpp"
+#include <array>
+#include <cerrno>
 #include <cstring>
 
 namespace util
@@ -17,54 +19,71 @@ namespace util
 
 // error_category
 
-class generic_error_category : public error_category
+namespace
 {
-public:
-	virtual const char *name() const noexcept;
-	virtual const char *message(int ev) const noexcept;
-};
 
-const char *generic_error_category::name() const noexcept
-{
-	return "generic";
-}
-
-const char *generic_error_category::message(int ev) const noexcept
+#ifdef CONFIG_APP_ERRNO_MESSAGE_SUBSET
+// Only the errno values that the Zephyr drivers and subsystems used by the application return, so
+// that the string table of strerror() is not linked. Other values give "Unknown error".
+constexpr auto errno_messages = [] {
+	std::array<error_message, 27> messages{{
+		{EPERM, "Not owner"},
+		{ENOENT, "No such file or directory"},
+		{EINTR, "Interrupted system call"},
+		{EIO, "I/O error"},
+		{ENXIO, "No such device or address"},
+		{E2BIG, "Arg list too long"},
+		{EAGAIN, "No more contexts"},
+		{ENOMEM, "Not enough core"},
+		{EACCES, "Permission denied"},
+		{EFAULT, "Bad address"},
+		{EBUSY, "Device or resource busy"},
+		{EEXIST, "File exists"},
+		{ENODEV, "No such device"},
+		{EINVAL, "Invalid argument"},
+		{ENOSPC, "No space left on device"},
+		{EROFS, "Read-only file system"},
+		{ERANGE, "Result too large"},
+		{EDEADLK, "Resource deadlock avoided"},
+		{ENOSYS, "Function not implemented"},
+		{EBADMSG, "Invalid message"},
+		{EOVERFLOW, "Value overflow"},
+		{ENOBUFS, "No buffer space available"},
+		{EADDRINUSE, "Address already in use"},
+		{ETIMEDOUT, "Connection timed out"},
+		{EALREADY, "Operation already in progress"},
+		{ECANCELED, "Operation canceled"},
+		{ENOTSUP, "Unsupported value"},
+	}};
+	// the errno values differ between the C libraries, so the table is sorted at compile time
+	std::ranges::sort(messages, {}, &error_message::value);
+	return messages;
+}();
+static_assert(is_valid_message_table(errno_messages));
+
+constexpr error_category::message_function errno_fallback = nullptr;
+#else
+constexpr std::span<const error_message> errno_messages{};
+
+const char *errno_fallback(int ev)
 {
 	return strerror(ev);
 }
+#endif
+
+} // namespace
 
-const generic_error_category the_generic_error_category{};
+constinit const error_category the_generic_error_category{"generic", errno_messages, nullptr,
+							   errno_fallback};
 
 const error_category &generic_category() noexcept
 {
 	return the_generic_error_category;
 }
 
-class system_error_category : public error_category
-{
-public:
-	virtual const char *name() const noexcept;
-	virtual const char *message(int ev) const noexcept;
-	virtual error_condition default_error_condition(int ev) const noexcept;
-};
-
-const char *system_error_category::name() const noexcept
-{
-	return "system";
-}
-
-const char *system_error_category::message(int ev) const noexcept
-{
-	return strerror(ev);
-}
-
-error_condition system_error_category::default_error_condition(int ev) const noexcept
-{
-	return error_condition(ev, generic_category());
-}
-
-const system_error_category the_system_error_category{};
+// system errors are equivalent to the generic errors with the same value
+constinit const error_category the_system_error_category{
+	"system", errno_messages, &the_generic_error_category, errno_fallback};
 
 const error_category &system_category() noexcept
 {
@@ -19,7 +19,7 @@ namespace util
 
 error_condition error_category::default_error_condition(int ev) const noexcept
 {
-	return error_condition(ev, *this);
+	return error_condition(ev, (condition_category_ != nullptr) ? *condition_category_ : *this);
 }
 
 bool error_category::equivalent(int code, const error_condition &condition) const noexcept
@@ -32,4 +32,14 @@ bool error_category::equivalent(const error_code &code, int condition) const noe
 	return *this == code.category() && code.value() == condition;
 }
 
+const char *error_category::message(int ev) const noexcept
+{
+	const auto entry = std::ranges::lower_bound(messages_, ev, {}, &error_message::value);
+	if ((entry != messages_.end()) && (entry->value == ev)) {
+		return entry->message;
+	}
+
+	return (fallback_ != nullptr) ? fallback_(ev) : "Unknown error";
+}
+
 } // namespace util
@@ -12,25 +12,72 @@
 #ifndef SYSTEM_ERROR_ERROR_CATEGORY_HPP
 #define SYSTEM_ERROR_ERROR_CATEGORY_HPP
 
+#include <algorithm>
+#include <span>
+
 namespace util
 {
 class error_condition;
 class error_code;
 
+/**
+ * @brief Message of a single error value, as an entry of the message table of a category.
+ */
+struct error_message {
+	int value;
+	const char *message;
+};
+
+/**
+ * @brief Checks that a message table is sorted by value without duplicates (for static_assert).
+ */
+constexpr bool is_valid_message_table(std::span<const error_message> messages)
+{
+	return std::ranges::adjacent_find(messages, [](const auto &lhs, const auto &rhs) {
+		       return lhs.value >= rhs.value;
+	       }) == messages.end();
+}
+
+/**
+ * @brief Category of error values, described by its name and a constexpr table of messages.
+ *
+ * In contrast to std::error_category, the categories are not polymorphic: message lookup and
+ * comparisons are plain function calls, and the categories are constant-initialized objects that
+ * reside in ROM. Error values of a category are either their own condition or, if a condition
+ * category is given (as for system errors), a condition of the same value in that category.
+ */
 class error_category
 {
 public:
-	virtual ~error_category() noexcept = default;
+	/**
+	 * @brief Fallback for values without an entry in the message table (e.g. strerror).
+	 */
+	using message_function = const char *(*)(int ev);
+
+	constexpr error_category(const char *name, std::span<const error_message> messages,
+				 const error_category *condition_category = nullptr,
+				 message_function fallback = nullptr) noexcept
+		: name_(name), messages_(messages), condition_category_(condition_category),
+		  fallback_(fallback)
+	{
+	}
 
-	error_category() noexcept = default;
 	error_category(const error_category &) = delete;
 	error_category &operator=(const error_category &) = delete;
 
-	virtual const char *name() const noexcept = 0;
-	virtual error_condition default_error_condition(int ev) const noexcept;
-	virtual bool equivalent(int code, const error_condition &condition) const noexcept;
-	virtual bool equivalent(const error_code &code, int condition) const noexcept;
-	virtual const char *message(int ev) const noexcept = 0;
+	const char *name() const noexcept
+	{
+		return name_;
+	}
+
+	error_condition default_error_condition(int ev) const noexcept;
+	bool equivalent(int code, const error_condition &condition) const noexcept;
+	bool equivalent(const error_code &code, int condition) const noexcept;
+
+	/**
+	 * @brief Looks up the message of the value by a binary search in the message table.
+	 */
+	const char *message(int ev) const noexcept;
 
 	bool operator==(const error_category &rhs) const noexcept
 	{
@@ -46,6 +93,12 @@ public:
 	{
 		return this < &rhs;
 	}
+
+private:
+	const char *name_;
+	std::span<const error_message> messages_;
+	const error_category *condition_category_;
+	message_function fallback_;
 };
 
 const error_category &system_category() noexcept;
@@ -0,0 +1,146 @@
+#include <zephyr/drivers/flash.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/ztest.h>
+#include "paths.hpp"
+#include "storage/storage_error.hpp"
+#include <cerrno>
+
+namespace
+{
+
+constexpr size_t iterations = 1000U;
+
+constexpr uint16_t existing_id = 1U;
+constexpr uint16_t missing_id = 2U;
+
+/**
+ * @brief Average cycles of a call of the function.
+ */
+template <typename function_type>
+uint32_t measure(function_type &&function)
+{
+	const auto start = k_cycle_get_32();
+	for (size_t i = 0; i < iterations; ++i) {
+		function();
+	}
+	return (k_cycle_get_32() - start) / iterations;
+}
+
+struct path_cycles {
+	uint32_t success;
+	uint32_t failure;
+};
+
+void print_cycles(const char *name, const path_cycles &raw, const path_cycles &typed)
+{
+	TC_PRINT("%-22s success: raw %u / typed %u cycles, failure: raw %u / typed %u cycles\n",
+		 name, raw.success, typed.success, raw.failure, typed.failure);
+}
+
+/**
+ * @brief Mounts the partition of the storage as plain NVS, like nvs_backend does.
+ */
+void mount_raw(struct nvs_fs &fs)
+{
+	fs.flash_device = FIXED_PARTITION_DEVICE(storage_partition);
+	fs.offset = FIXED_PARTITION_OFFSET(storage_partition);
+
+	struct flash_pages_info info;
+	zassert_ok(flash_get_page_info_by_offs(fs.flash_device, fs.offset, &info));
+	fs.sector_size = info.size;
+	fs.sector_count = CONFIG_APP_STORAGE_NVS_SECTOR_COUNT;
+
+	zassert_ok(nvs_mount(&fs));
+}
+
+} // namespace
+
+ZTEST_SUITE(error_path, NULL, NULL, NULL, NULL, NULL);
+
+/**
+ * @brief Zephyr results as int compared to os::result_to_error_code().
+ */
+ZTEST(error_path, test_result_to_error_code)
+{
+	volatile int success = 4;
+	volatile int failure = -EIO;
+
+	zassert_equal(error_path::raw_result(success), 0);
+	zassert_equal(error_path::raw_result(failure), -EIO);
+	zassert_false(error_path::converted_result(success).operator bool());
+	zassert_true(error_path::converted_result(failure) ==
+		     util::error_condition{util::errc::io_error});
+
+	volatile int raw_sink = 0;
+	volatile bool typed_sink = false;
+	const path_cycles raw{measure([&] { raw_sink = error_path::raw_result(success); }),
+			      measure([&] { raw_sink = error_path::raw_result(failure); })};
+	const path_cycles typed{
+		measure([&] { typed_sink = !!error_path::converted_result(success); }),
+		measure([&] { typed_sink = !!error_path::converted_result(failure); })};
+	print_cycles("result_to_error_code", raw, typed);
+}
+
+/**
+ * @brief Errors as negative errno compared to make_error_code() of an application category.
+ */
+ZTEST(error_path, test_make_error_code)
+{
+	volatile bool success = false;
+	volatile bool failure = true;
+
+	zassert_equal(error_path::raw_failure(success), 0);
+	zassert_equal(error_path::raw_failure(failure), -EMSGSIZE);
+	zassert_false(error_path::storage_failure(success).operator bool());
+	zassert_true(error_path::storage_failure(failure) ==
+		     util::error_code{storage_error_code::wrong_data_size});
+
+	volatile int raw_sink = 0;
+	volatile bool typed_sink = false;
+	const path_cycles raw{measure([&] { raw_sink = error_path::raw_failure(success); }),
+			      measure([&] { raw_sink = error_path::raw_failure(failure); })};
+	const path_cycles typed{
+		measure([&] { typed_sink = !!error_path::storage_failure(success); }),
+		measure([&] { typed_sink = !!error_path::storage_failure(failure); })};
+	print_cycles("make_error_code", raw, typed);
+}
+
+/**
+ * @brief nvs_read() with errno checks compared to non_volatile_storage::read<T>().
+ */
+ZTEST(error_path, test_storage_read)
+{
+	non_volatile_storage storage{};
+	zassert_false(storage.init().operator bool());
+	zassert_false(storage.clear().operator bool());
+	zassert_false(storage.init().operator bool());
+	zassert_false(storage.write<uint32_t>(existing_id, 42U).operator bool());
+
+	// only read from here on, so that both file systems see the same flash content
+	struct nvs_fs fs{};
+	mount_raw(fs);
+
+	uint32_t value = 0U;
+	zassert_ok(error_path::raw_read(fs, existing_id, value));
+	zassert_equal(value, 42U);
+	zassert_equal(error_path::raw_read(fs, missing_id, value), -ENOENT);
+
+	const auto result = error_path::typed_read(storage, existing_id);
+	zassert_true(result.has_value());
+	zassert_equal(result.value(), 42U);
+	zassert_false(error_path::typed_read(storage, missing_id).has_value());
+
+	volatile int raw_sink = 0;
+	volatile bool typed_sink = false;
+	const path_cycles raw{
+		measure([&] { raw_sink = error_path::raw_read(fs, existing_id, value); }),
+		measure([&] { raw_sink = error_path::raw_read(fs, missing_id, value); })};
+	const path_cycles typed{
+		measure([&] {
+			typed_sink = error_path::typed_read(storage, existing_id).has_value();
+		}),
+		measure([&] {
+			typed_sink = error_path::typed_read(storage, missing_id).has_value();
+		})};
+	print_cycles("non_volatile_storage", raw, typed);
+}
@@ -0,0 +1,48 @@
+#include "paths.hpp"
+#include "os/kernel.hpp"
+#include "storage/storage_error.hpp"
+#include <cerrno>
+
+namespace error_path
+{
+
+__noinline int raw_result(int result)
+{
+	return (result < 0) ? result : 0;
+}
+
+__noinline util::error_code converted_result(int result)
+{
+	return os::result_to_error_code(result);
+}
+
+__noinline int raw_failure(bool fail)
+{
+	return fail ? -EMSGSIZE : 0;
+}
+
+__noinline util::error_code storage_failure(bool fail)
+{
+	if (fail) {
+		return storage_error_code::wrong_data_size;
+	}
+	return {};
+}
+
+__noinline int raw_read(struct nvs_fs &fs, uint16_t id, uint32_t &value)
+{
+	const auto result = nvs_read(&fs, id, &value, sizeof(value));
+	if (result < 0) {
+		return result;
+	}
+
+	return (static_cast<size_t>(result) == sizeof(value)) ? 0 : -EMSGSIZE;
+}
+
+__noinline std::expected<uint32_t, util::error_code> typed_read(non_volatile_storage &storage,
+								uint16_t id)
+{
+	return storage.read<uint32_t>(id);
+}
+
+} // namespace error_path
@@ -0,0 +1,40 @@
+#ifndef TESTS_ERROR_PATH_PATHS_HPP
+#define TESTS_ERROR_PATH_PATHS_HPP
+
+#include <zephyr/fs/nvs.h>
+#include "storage/non_volatile_storage.hpp"
+#include "util/system_error.hpp"
+#include <expected>
+
+/**
+ * @brief Pairs of functions that propagate the same result once as raw errno value (int) and once
+ *        as util::error_code or std::expected.
+ *
+ * The functions are defined in their own translation unit and are not inlined, so that their cycles
+ * include the call and the return of the result, and their sizes are reported by the target
+ * error_path_size.
+ */
+namespace error_path
+{
+
+/// Baseline: negative Zephyr results are errors, zero or positive values are no error.
+int raw_result(int result);
+
+/// os::result_to_error_code() of the same result.
+util::error_code converted_result(int result);
+
+/// Baseline: a failure as negative errno value.
+int raw_failure(bool fail);
+
+/// The same failure as error code of the storage category (make_error_code).
+util::error_code storage_failure(bool fail);
+
+/// Baseline: nvs_read() of a fixed size value with the checks of non_volatile_storage::read<T>.
+int raw_read(struct nvs_fs &fs, uint16_t id, uint32_t &value);
+
+/// non_volatile_storage::read<T>() of the same value.
+std::expected<uint32_t, util::error_code> typed_read(non_volatile_storage &storage, uint16_t id);
+
+} // namespace error_path
+
+#endif /* TESTS_ERROR_PATH_PATHS_HPP */
@@ -0,0 +1,91 @@
+#include "protobuf/footprint.pb.h"
+#include "protobuf/protobuf_message.hpp"
+#include "storage/non_volatile_storage.hpp"
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(footprint, LOG_LEVEL_INF);
+
+// the ten message types with a string keep nanopb, only the scalar one gets the codec
+PROTOBUF_NANOPB_CODEC(Message01);
+PROTOBUF_NANOPB_CODEC(Message02);
+PROTOBUF_NANOPB_CODEC(Message03);
+PROTOBUF_NANOPB_CODEC(Message04);
+PROTOBUF_NANOPB_CODEC(Message05);
+PROTOBUF_NANOPB_CODEC(Message06);
+PROTOBUF_NANOPB_CODEC(Message07);
+PROTOBUF_NANOPB_CODEC(Message08);
+PROTOBUF_NANOPB_CODEC(Message09);
+PROTOBUF_NANOPB_CODEC(Message10);
+PROTOBUF_SCALAR_CODEC(ScalarMessage);
+
+namespace
+{
+
+/**
+ * @brief Instantiates everything that the application needs per message type: the message, its
+ *        encoding and decoding and the storage read and write.
+ *
+ * The ROM per message type is the difference between the builds with one and ten message types
+ * (see west build -t protobuf_footprint).
+ */
+template <typename message_type, size_t maximum_encoded_size>
+void round_trip(non_volatile_storage &storage, uint16_t id, const pb_msgdesc_t &definition)
+{
+	protobuf::message<message_type, maximum_encoded_size> message{definition};
+	message.data().id = id;
+
+	if (const auto error = storage.write(id, message)) {
+		LOG_ERR("Failed to write message %u: %s", id, error.message());
+		return;
+	}
+
+	if (const auto error = storage.read(id, message)) {
+		LOG_ERR("Failed to read message %u: %s", id, error.message());
+	}
+}
+
+} // namespace
+
+int main()
+{
+	non_volatile_storage storage{};
+	if (const auto error = storage.init()) {
+		LOG_ERR("Failed to init storage: %s", error.message());
+		return 0;
+	}
+
+	round_trip<Message01, Message01_size>(storage, 1U, Message01_msg);
+#if CONFIG_FOOTPRINT_MESSAGE_TYPES >= 2
+	round_trip<Message02, Message02_size>(storage, 2U, Message02_msg);
+#endif
+#if CONFIG_FOOTPRINT_MESSAGE_TYPES >= 3
+	round_trip<Message03, Message03_size>(storage, 3U, Message03_msg);
+#endif
+#if CONFIG_FOOTPRINT_MESSAGE_TYPES >= 4
+	round_trip<Message04, Message04_size>(storage, 4U, Message04_msg);
+#endif
+#if CONFIG_FOOTPRINT_MESSAGE_TYPES >= 5
+	round_trip<Message05, Message05_size>(storage, 5U, Message05_msg);
+#endif
+#if CONFIG_FOOTPRINT_MESSAGE_TYPES >= 6
+	round_trip<Message06, Message06_size>(storage, 6U, Message06_msg);
+#endif
+#if CONFIG_FOOTPRINT_MESSAGE_TYPES >= 7
+	round_trip<Message07, Message07_size>(storage, 7U, Message07_msg);
+#endif
+#if CONFIG_FOOTPRINT_MESSAGE_TYPES >= 8
+	round_trip<Message08, Message08_size>(storage, 8U, Message08_msg);
+#endif
+#if CONFIG_FOOTPRINT_MESSAGE_TYPES >= 9
+	round_trip<Message09, Message09_size>(storage, 9U, Message09_msg);
+#endif
+#if CONFIG_FOOTPRINT_MESSAGE_TYPES >= 10
+	round_trip<Message10, Message10_size>(storage, 10U, Message10_msg);
+#endif
+#ifdef CONFIG_FOOTPRINT_SCALAR_MESSAGE
+	round_trip<ScalarMessage, ScalarMessage_size>(storage, 11U, ScalarMessage_msg);
+#endif
+
+	LOG_INF("Footprint of %d message types", CONFIG_FOOTPRINT_MESSAGE_TYPES);
+	return 0;
+}
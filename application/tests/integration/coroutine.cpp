@@ -0,0 +1,205 @@
+#include "assertions.hpp"
+#include "os/coroutine.hpp"
+#include "protobuf/async_message.hpp"
+#include "scalar_types_messages.hpp"
+#include "storage/async_storage.hpp"
+#include <zephyr/ztest.h>
+#include <array>
+
+namespace
+{
+
+constexpr uint16_t counter_id = 1U;
+constexpr size_t counter_runs = 3U;
+
+using counter_message = protobuf::message<ScalarTypes, ScalarTypes_size>;
+
+/**
+ * @brief State shared between a test and its coroutines.
+ */
+struct completion {
+	struct k_sem done;
+	uint32_t value;
+	util::error_code error;
+};
+
+/**
+ * @brief Increments a counter in the storage, written linearly without blocking the work queue.
+ */
+os::task increment_counter(non_volatile_storage &storage, completion &state)
+{
+	counter_message message{ScalarTypes_msg};
+
+	// a missing counter is started at zero
+	(void)co_await storage::async_read(storage, counter_id, message);
+	message.data().uint32_value++;
+
+	state.error = co_await storage::async_write(storage, counter_id, message);
+	state.value = message.data().uint32_value;
+	k_sem_give(&state.done);
+}
+
+os::task round_trip(const counter_message &input, counter_message &output, completion &state)
+{
+	std::array<uint8_t, ScalarTypes_size> buffer;
+
+	const auto encoded = co_await protobuf::async_encode(input, buffer);
+	if (!encoded) {
+		state.error = encoded.error();
+	} else {
+		state.error = co_await protobuf::async_decode(output, encoded.value());
+	}
+	k_sem_give(&state.done);
+}
+
+os::task sleep_and_record(std::chrono::milliseconds timeout, uint32_t &elapsed_ms,
+			  struct k_sem &done)
+{
+	const auto start = k_uptime_get_32();
+	co_await os::async_sleep(timeout);
+	elapsed_ms = k_uptime_get_32() - start;
+	k_sem_give(&done);
+}
+
+os::task record_steps(uint32_t id, std::chrono::milliseconds period, std::span<uint32_t> order,
+		      size_t &position, struct k_sem &done)
+{
+	for (size_t i = 0; i < 3U; ++i) {
+		co_await os::async_sleep(period);
+		order[position++] = id; // all coroutines run on the same thread
+	}
+	k_sem_give(&done);
+}
+
+os::task wait_for(struct k_sem &start, struct k_sem &done)
+{
+	// blocking here would block all coroutines, hence the polling
+	while (k_sem_take(&start, K_NO_WAIT) != 0) {
+		co_await os::async_sleep(1ms);
+	}
+	k_sem_give(&done);
+}
+
+os::task large_frame(struct k_sem &done)
+{
+	std::array<uint8_t, CONFIG_APP_COROUTINE_FRAME_SIZE> state{};
+	co_await os::async_sleep(1ms);
+	k_sem_give(&done);
+	(void)state;
+}
+
+} // namespace
+
+ZTEST_SUITE(coroutine, NULL, NULL, NULL, NULL, NULL);
+
+/**
+ * @brief The boot counter flow (read, increment, write) as a coroutine on the work queue.
+ */
+ZTEST(coroutine, test_storage_counter)
+{
+	non_volatile_storage storage{};
+	zassert_no_error(storage.init());
+	zassert_no_error(storage.clear());
+	zassert_no_error(storage.init());
+
+	for (uint32_t run = 1U; run <= counter_runs; ++run) {
+		completion state{};
+		k_sem_init(&state.done, 0, 1);
+
+		zassert_true(static_cast<bool>(increment_counter(storage, state)));
+		zassert_ok(k_sem_take(&state.done, K_SECONDS(1)));
+		zassert_no_error(state.error);
+		zassert_equal(state.value, run);
+	}
+
+	// the coroutines did write the same record as the synchronous interface reads
+	counter_message message{ScalarTypes_msg};
+	zassert_no_error(storage.read(counter_id, message));
+	zassert_equal(message.data().uint32_value, counter_runs);
+}
+
+ZTEST(coroutine, test_protobuf_round_trip)
+{
+	counter_message input{ScalarTypes_msg};
+	input.data() = ScalarTypes_init_default;
+	input.data().uint32_value = 42U;
+	input.data().sint64_value = -9000000000;
+
+	counter_message output{ScalarTypes_msg};
+	output.data() = ScalarTypes_init_default;
+
+	completion state{};
+	k_sem_init(&state.done, 0, 1);
+	zassert_true(static_cast<bool>(round_trip(input, output, state)));
+	zassert_ok(k_sem_take(&state.done, K_SECONDS(1)));
+	zassert_no_error(state.error);
+	zassert_equal(output.data().uint32_value, 42U);
+	zassert_equal(output.data().sint64_value, -9000000000);
+}
+
+ZTEST(coroutine, test_sleep)
+{
+	struct k_sem done;
+	k_sem_init(&done, 0, 1);
+	uint32_t elapsed_ms = 0U;
+
+	zassert_true(static_cast<bool>(sleep_and_record(50ms, elapsed_ms, done)));
+	zassert_ok(k_sem_take(&done, K_SECONDS(1)));
+	zassert_true(elapsed_ms >= 50U && elapsed_ms <= 52U, "slept %u ms", elapsed_ms);
+}
+
+/**
+ * @brief Sleeping coroutines do not block each other on the single work queue thread.
+ */
+ZTEST(coroutine, test_interleaving)
+{
+	struct k_sem done;
+	k_sem_init(&done, 0, 2);
+	std::array<uint32_t, 6U> order{};
+	size_t position = 0U;
+
+	zassert_true(static_cast<bool>(record_steps(1U, 20ms, order, position, done)));
+	zassert_true(static_cast<bool>(record_steps(2U, 30ms, order, position, done)));
+	zassert_ok(k_sem_take(&done, K_SECONDS(1)));
+	zassert_ok(k_sem_take(&done, K_SECONDS(1)));
+
+	// 20 (1), 30 (2), 40 (1), 60 (1 and 2), 90 (2)
+	zassert_equal(order[0], 1U);
+	zassert_equal(order[1], 2U);
+	zassert_equal(order[2], 1U);
+	zassert_equal(order[5], 2U);
+}
+
+/**
+ * @brief Coroutines are not started if no frame is available or their frame is too large.
+ */
+ZTEST(coroutine, test_frame_pool)
+{
+	// the frames of the previous tests are freed after their coroutines signaled the completion
+	k_msleep(10);
+
+	struct k_sem start;
+	struct k_sem done;
+	k_sem_init(&start, 0, CONFIG_APP_COROUTINE_MAX_TASKS);
+	k_sem_init(&done, 0, CONFIG_APP_COROUTINE_MAX_TASKS);
+
+	for (size_t i = 0; i < CONFIG_APP_COROUTINE_MAX_TASKS; ++i) {
+		zassert_true(static_cast<bool>(wait_for(start, done)));
+	}
+	zassert_false(static_cast<bool>(wait_for(start, done)), "all frames are in use");
+
+	for (size_t i = 0; i < CONFIG_APP_COROUTINE_MAX_TASKS; ++i) {
+		k_sem_give(&start);
+	}
+	for (size_t i = 0; i < CONFIG_APP_COROUTINE_MAX_TASKS; ++i) {
+		zassert_ok(k_sem_take(&done, K_SECONDS(1)));
+	}
+
+	// the frames are available again once the coroutines ended
+	k_msleep(10);
+	zassert_true(static_cast<bool>(wait_for(start, done)));
+	k_sem_give(&start);
+	zassert_ok(k_sem_take(&done, K_SECONDS(1)));
+
+	zassert_false(static_cast<bool>(large_frame(done)), "frame exceeds the frame size");
+}
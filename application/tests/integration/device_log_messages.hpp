@@ -0,0 +1,12 @@
+#ifndef TESTS_INTEGRATION_DEVICE_LOG_MESSAGES_HPP
+#define TESTS_INTEGRATION_DEVICE_LOG_MESSAGES_HPP
+
+#include "protobuf/device_log.pb.h"
+#include "protobuf/scalar_codec.hpp"
+
+// Codecs of the messages of device_log.proto, included instead of device_log.pb.h (see
+// protobuf/storage_messages.hpp).
+PROTOBUF_NANOPB_CODEC(DeviceLog);
+PROTOBUF_NANOPB_CODEC(StaticDeviceLog);
+
+#endif /* TESTS_INTEGRATION_DEVICE_LOG_MESSAGES_HPP */
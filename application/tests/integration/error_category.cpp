@@ -0,0 +1,59 @@
+#include "protobuf/protobuf_error.hpp"
+#include "storage/storage_error.hpp"
+#include "util/system_error.hpp"
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <cerrno>
+
+namespace
+{
+
+constexpr size_t iterations = 1000U;
+
+uint32_t message_cycles(const util::error_code &error)
+{
+	const char *volatile message = nullptr;
+
+	const auto start = k_cycle_get_32();
+	for (size_t i = 0; i < iterations; ++i) {
+		message = error.message();
+	}
+	(void)message;
+
+	return (k_cycle_get_32() - start) / iterations;
+}
+
+} // namespace
+
+ZTEST_SUITE(error_category, NULL, NULL, NULL, NULL, NULL);
+
+/**
+ * @brief The messages of the application categories come from their tables.
+ */
+ZTEST(error_category, test_messages)
+{
+	zassert_str_equal(util::error_code{storage_error_code::wrong_data_size}.message(),
+			  "Wrong data size");
+	zassert_str_equal(util::error_code{protobuf::error_code::decode_failure}.message(),
+			  "Decode failure");
+	const auto &storage_category =
+		util::error_code{storage_error_code::wrong_data_size}.category();
+	zassert_str_equal(util::error_code(0xFF, storage_category).message(), "Unknown error");
+
+	// errno values of the Zephyr drivers have a message, with and without the errno subset
+	const util::error_code io_error{EIO, util::system_category()};
+	zassert_not_null(io_error.message());
+	zassert_true(io_error == util::error_condition{util::errc::io_error});
+}
+
+/**
+ * @brief Cycles of error_code::message(), to compare the errno subset with strerror().
+ */
+ZTEST(error_category, test_benchmark_message)
+{
+	TC_PRINT("message(): storage %u, protobuf %u, errno %u, unknown errno %u cycles\n",
+		 message_cycles(storage_error_code::checksum_mismatch),
+		 message_cycles(protobuf::error_code::encode_failure),
+		 message_cycles(util::error_code{ENOSPC, util::system_category()}),
+		 message_cycles(util::error_code{EMLINK, util::system_category()}));
+}
@@ -0,0 +1,87 @@
+#include "assertions.hpp"
+#include "storage/non_volatile_storage.hpp"
+#include <zephyr/ztest.h>
+
+namespace
+{
+
+struct mount_time {
+	uint32_t init_us;         ///< time until init() returned
+	uint32_t first_access_us; ///< time until the first storage operation returned
+};
+
+/**
+ * @brief Measures how long mounting the storage blocks the caller of init() and the first access.
+ */
+mount_time measure_mount_time()
+{
+	non_volatile_storage storage{};
+
+	const auto start = k_cycle_get_32();
+	zassert_no_error(storage.init());
+	const auto initialized = k_cycle_get_32();
+	(void)storage.read<uint32_t>(1);
+	const auto accessed = k_cycle_get_32();
+
+	return {k_cyc_to_us_floor32(initialized - start), k_cyc_to_us_floor32(accessed - start)};
+}
+
+void clear_storage()
+{
+	non_volatile_storage storage{};
+	zassert_no_error(storage.init());
+	zassert_no_error(storage.clear());
+}
+
+/**
+ * @brief Writes records with increasing IDs until the storage has no space left anymore.
+ */
+size_t fill_storage()
+{
+	non_volatile_storage storage{};
+	zassert_no_error(storage.init());
+
+	size_t records = 0;
+	for (uint16_t id = 1; !storage.write<uint32_t>(id, id); ++id) {
+		++records;
+	}
+	return records;
+}
+
+void *setup(void)
+{
+	clear_storage();
+	return nullptr;
+}
+
+void teardown(void *)
+{
+	clear_storage();
+}
+
+} // namespace
+
+ZTEST_SUITE(mount_time, NULL, setup, NULL, NULL, teardown);
+
+/**
+ * @brief Measure the boot-time cost of mounting the storage with an empty and a full partition.
+ *
+ * With CONFIG_APP_STORAGE_LAZY_MOUNT the time until init() returns must not depend on how much
+ * data is stored, as the partition is only scanned by the mount thread.
+ */
+ZTEST(mount_time, test_mount_time_empty_and_full)
+{
+	const auto empty = measure_mount_time();
+	TC_PRINT("empty partition: init() %u us, first access %u us\n", empty.init_us,
+		 empty.first_access_us);
+
+	const auto records = fill_storage();
+	zassert_true(records > 0U);
+
+	const auto full = measure_mount_time();
+	TC_PRINT("full partition (%zu records): init() %u us, first access %u us\n", records,
+		 full.init_us, full.first_access_us);
+
+	zassert_true(empty.init_us <= empty.first_access_us);
+	zassert_true(full.init_us <= full.first_access_us);
+}
@@ -1,22 +1,7 @@
+#include "assertions.hpp"
 #include "storage/non_volatile_storage.hpp"
 #include <zephyr/ztest.h>
 
-/**
- * @brief Assert that @a error_code indicates an error (failure)
- * @param error_code std::error_code to check
- * @param ... Optional message and variables to print if the assertion fails
- */
-#define zassert_error(error_code, ...)                                                             \
-	zassert_true(static_cast<bool>(error_code), #error_code " is error", ##__VA_ARGS__)
-
-/**
- * @brief Assert that @a error_code does not indicate an error (failure)
- * @param error_code std::error_code to check
- * @param ... Optional message and variables to print if the assertion fails
- */
-#define zassert_no_error(error_code, ...)                                                          \
-	zassert_false(static_cast<bool>(error_code), #error_code " is error", ##__VA_ARGS__)
-
 ZTEST_SUITE(non_volatile_storage, NULL, NULL, NULL, NULL, NULL);
 
 /**
@@ -0,0 +1,118 @@
+#include "os/periodic_task.hpp"
+#include <zephyr/ztest.h>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+
+namespace
+{
+
+constexpr uint32_t jitter_runs = 1000U;
+constexpr auto jitter_period = 10ms;
+
+/**
+ * @brief Records the intervals between the executions of a periodic task.
+ */
+struct interval_recorder {
+	os::periodic_task *task;
+	uint32_t runs;
+	uint32_t target_runs;
+	uint32_t last_cycles;
+	uint64_t total_cycles;     ///< sum of all intervals, i.e. from the first to the last run
+	uint32_t max_deviation_us; ///< largest difference of an interval to the period
+	struct k_sem done;
+};
+
+void record_interval(void *context)
+{
+	auto &recorder = *static_cast<interval_recorder *>(context);
+	const auto now = k_cycle_get_32();
+
+	if (recorder.runs > 0U) {
+		const uint32_t interval = now - recorder.last_cycles;
+		recorder.total_cycles += interval;
+
+		const int64_t deviation = static_cast<int64_t>(k_cyc_to_us_floor32(interval)) -
+					  std::chrono::microseconds{jitter_period}.count();
+		recorder.max_deviation_us = std::max(recorder.max_deviation_us,
+						     static_cast<uint32_t>(std::abs(deviation)));
+	}
+	recorder.last_cycles = now;
+
+	if (++recorder.runs == recorder.target_runs) {
+		recorder.task->stop();
+		k_sem_give(&recorder.done);
+	}
+}
+
+void count_run(void *context)
+{
+	++*static_cast<uint32_t *>(context);
+}
+
+} // namespace
+
+ZTEST_SUITE(periodic_task, NULL, NULL, NULL, NULL, NULL);
+
+/**
+ * @brief The executions follow absolute deadlines, so that the jitter does not accumulate.
+ */
+ZTEST(periodic_task, test_period_jitter)
+{
+	interval_recorder recorder{};
+	recorder.target_runs = jitter_runs;
+	k_sem_init(&recorder.done, 0, 1);
+
+	os::periodic_task task{record_interval, &recorder};
+	recorder.task = &task;
+	task.start(jitter_period);
+
+	zassert_ok(k_sem_take(&recorder.done, K_MSEC(2 * jitter_runs * jitter_period.count())));
+	zassert_equal(task.overruns(), 0U);
+
+	// the time from the first to the last run must be a multiple of the period (no drift)
+	const uint64_t expected_us =
+		(jitter_runs - 1U) * std::chrono::microseconds{jitter_period}.count();
+	const uint64_t total_us = k_cyc_to_us_floor64(recorder.total_cycles);
+	const auto drift_us = static_cast<uint32_t>(
+		(total_us > expected_us) ? total_us - expected_us : expected_us - total_us);
+	const auto tick_us = static_cast<uint32_t>(k_ticks_to_us_floor64(1));
+
+	TC_PRINT("%u runs of %u ms: max jitter %u us, drift %u us (tick %u us)\n", jitter_runs,
+		 static_cast<uint32_t>(jitter_period.count()), recorder.max_deviation_us, drift_us,
+		 tick_us);
+	zassert_true(drift_us <= 2U * tick_us, "periods must not accumulate to a drift");
+}
+
+/**
+ * @brief Several tasks with different periods share the periodic task thread.
+ */
+ZTEST(periodic_task, test_multiple_tasks)
+{
+	constexpr std::array periods{10ms, 20ms, 50ms};
+	std::array<uint32_t, periods.size()> runs{};
+
+	os::periodic_task first{count_run, &runs[0]};
+	os::periodic_task second{count_run, &runs[1]};
+	os::periodic_task third{count_run, &runs[2]};
+	const std::array<os::periodic_task *, periods.size()> tasks{&first, &second, &third};
+
+	const int64_t start = k_uptime_get();
+	for (size_t i = 0; i < periods.size(); ++i) {
+		tasks[i]->start(periods[i]);
+	}
+	k_msleep(1005);
+	for (auto *task : tasks) {
+		task->stop();
+	}
+	const int64_t elapsed_ms = k_uptime_get() - start;
+
+	// the sleep can take longer under load, and the last deadline may expire while stopping
+	for (size_t i = 0; i < periods.size(); ++i) {
+		const auto deadlines = static_cast<uint32_t>(elapsed_ms / periods[i].count());
+		const uint32_t executions = runs[i] + tasks[i]->overruns();
+		zassert_between_inclusive(executions, deadlines - 1U, deadlines + 1U,
+					  "task %zu ran %u times in %u ms", i, runs[i],
+					  static_cast<uint32_t>(elapsed_ms));
+	}
+}
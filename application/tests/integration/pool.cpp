@@ -0,0 +1,131 @@
+#include "assertions.hpp"
+#include "os/pool.hpp"
+#include "protobuf/protobuf_message.hpp"
+#include "scalar_types_messages.hpp"
+#include <zephyr/ztest.h>
+#include <algorithm>
+#include <array>
+#include <new>
+
+namespace
+{
+
+constexpr size_t pool_size = 4U;
+constexpr uint32_t benchmark_iterations = 100U;
+
+using scalar_message = protobuf::message<ScalarTypes, ScalarTypes_size>;
+
+struct counted {
+	explicit counted(int value) : value(value)
+	{
+		++alive;
+	}
+
+	~counted()
+	{
+		--alive;
+	}
+
+	int value;
+	static inline size_t alive = 0U;
+};
+
+os::pool<counted, pool_size> counted_pool;
+os::pool<scalar_message, pool_size> message_pool;
+
+} // namespace
+
+ZTEST_SUITE(pool, NULL, NULL, NULL, NULL, NULL);
+
+/**
+ * @brief Objects are constructed on allocation and destroyed and freed with their handle.
+ */
+ZTEST(pool, test_allocate_and_free)
+{
+	std::array<os::pool<counted, pool_size>::handle, pool_size> handles;
+	for (size_t i = 0; i < pool_size; ++i) {
+		auto object = counted_pool.allocate(static_cast<int>(i));
+		zassert_true(object.has_value());
+		zassert_equal((*object)->value, static_cast<int>(i));
+		handles[i] = std::move(object.value());
+	}
+	zassert_equal(counted::alive, pool_size);
+	zassert_equal(counted_pool.available(), 0U);
+
+	// all blocks are in use
+	const auto exhausted = counted_pool.allocate(42);
+	zassert_false(exhausted.has_value());
+	zassert_true(exhausted.error() == util::error_condition{util::errc::not_enough_memory});
+
+	// moving transfers the ownership, resetting frees the block for the next allocation
+	auto moved = std::move(handles[0]);
+	zassert_false(static_cast<bool>(handles[0]));
+	moved.reset();
+	zassert_equal(counted::alive, pool_size - 1U);
+	zassert_true(counted_pool.allocate(42).has_value());
+
+	for (auto &handle : handles) {
+		handle.reset();
+	}
+	zassert_equal(counted::alive, 0U);
+	zassert_equal(counted_pool.used(), 0U);
+}
+
+/**
+ * @brief Protobuf messages can be allocated from a pool instead of living on the stack.
+ */
+ZTEST(pool, test_protobuf_message)
+{
+	auto message = message_pool.allocate(ScalarTypes_msg);
+	zassert_true(message.has_value());
+
+	auto &data = (*message)->data();
+	data = ScalarTypes_init_default;
+	data.uint32_value = 42U;
+
+	std::array<uint8_t, scalar_message::maximum_encoded_size> buffer{};
+	const auto encoded = (*message)->encode(buffer);
+	zassert_true(encoded.has_value());
+
+	auto decoded = message_pool.allocate(ScalarTypes_msg);
+	zassert_true(decoded.has_value());
+	zassert_no_error((*decoded)->decode(encoded.value()));
+	zassert_equal((*decoded)->data().uint32_value, 42U);
+}
+
+/**
+ * @brief Cycles of allocating and freeing a protobuf message compared to k_malloc().
+ */
+ZTEST(pool, test_benchmark_latency)
+{
+	uint32_t pool_cycles = 0U;
+	uint32_t pool_max = 0U;
+	uint32_t malloc_cycles = 0U;
+	uint32_t malloc_max = 0U;
+
+	for (size_t i = 0; i < benchmark_iterations; ++i) {
+		auto start = k_cycle_get_32();
+		{
+			auto message = message_pool.allocate(ScalarTypes_msg);
+			zassert_true(message.has_value());
+		}
+		uint32_t cycles = k_cycle_get_32() - start;
+		pool_cycles += cycles;
+		pool_max = std::max(pool_max, cycles);
+
+		start = k_cycle_get_32();
+		void *memory = k_malloc(sizeof(scalar_message));
+		zassert_not_null(memory);
+		auto *message = new (memory) scalar_message{ScalarTypes_msg};
+		message->~scalar_message();
+		k_free(memory);
+		cycles = k_cycle_get_32() - start;
+		malloc_cycles += cycles;
+		malloc_max = std::max(malloc_max, cycles);
+	}
+
+	TC_PRINT("allocate and free of %zu bytes: pool %u (max %u) cycles, k_malloc %u (max %u) "
+		 "cycles\n",
+		 sizeof(scalar_message), pool_cycles / benchmark_iterations, pool_max,
+		 malloc_cycles / benchmark_iterations, malloc_max);
+}
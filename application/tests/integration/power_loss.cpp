@@ -0,0 +1,318 @@
+#include "assertions.hpp"
+#include "storage/non_volatile_storage.hpp"
+#include <zephyr/stats/stats.h>
+#include <zephyr/ztest.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <optional>
+
+namespace
+{
+
+constexpr uint16_t record_ids = 6U;
+constexpr uint32_t workload_steps = 160U;
+constexpr size_t max_record_size = 64U;
+
+/// Bytes of a torn write that still reach the flash (a part of an ATE or of the data).
+constexpr uint32_t torn_bytes = 3U;
+
+/**
+ * @brief Counters and thresholds of the flash simulator (CONFIG_FLASH_SIMULATOR_STATS).
+ *
+ * The simulator ignores the write with the number max_write_calls (except for its first max_len
+ * bytes) and all writes after it, as well as the erase with the number max_erase_calls and all
+ * erases after it. A threshold of 0 is disabled.
+ */
+struct flash_simulator {
+	uint32_t *write_calls;
+	uint32_t *erase_calls;
+	uint32_t *max_write_calls;
+	uint32_t *max_erase_calls;
+	uint32_t *max_len;
+
+	void power_on()
+	{
+		*max_write_calls = 0U;
+		*max_erase_calls = 0U;
+		*max_len = 0U;
+	}
+};
+
+flash_simulator find_flash_simulator()
+{
+	flash_simulator simulator{};
+	const auto find = [](struct stats_hdr *header, void *argument, const char *name,
+			     uint16_t offset) {
+		auto &found = *static_cast<flash_simulator *>(argument);
+		auto *const counter =
+			reinterpret_cast<uint32_t *>(reinterpret_cast<uint8_t *>(header) + offset);
+		if (strcmp(name, "flash_write_calls") == 0) {
+			found.write_calls = counter;
+		} else if (strcmp(name, "flash_erase_calls") == 0) {
+			found.erase_calls = counter;
+		} else if (strcmp(name, "max_write_calls") == 0) {
+			found.max_write_calls = counter;
+		} else if (strcmp(name, "max_erase_calls") == 0) {
+			found.max_erase_calls = counter;
+		} else if (strcmp(name, "max_len") == 0) {
+			found.max_len = counter;
+		}
+		return 0;
+	};
+
+	for (const char *const group : {"flash_sim_stats", "flash_sim_thresholds"}) {
+		if (auto *const header = stats_group_find(group)) {
+			(void)stats_walk(header, find, &simulator);
+		}
+	}
+	return simulator;
+}
+
+/**
+ * @brief A step of the scripted workload: writes or deletes a record.
+ */
+struct step {
+	uint16_t id;
+	size_t length; ///< 0 for deleting the record
+	uint8_t value; ///< value of all bytes of the record
+};
+
+/**
+ * @brief Steps that update a few records with varying sizes, so that the sectors fill up and
+ *        get garbage collected several times.
+ */
+step workload_step(uint32_t index)
+{
+	const auto id = static_cast<uint16_t>(1U + index % record_ids);
+	if (index % 11U == 10U) {
+		return {id, 0U, 0U};
+	}
+	return {id, 32U + (index * 7U) % (max_record_size - 32U), static_cast<uint8_t>(index)};
+}
+
+util::error_code execute(non_volatile_storage &storage, const step &next)
+{
+	std::array<uint8_t, max_record_size> data;
+	data.fill(next.value);
+	return storage.write(next.id, std::span<const uint8_t>{data}.first(next.length));
+}
+
+/// Whether a read record is the one that a step left behind (nothing for no step).
+bool is_left_by(const std::expected<std::span<uint8_t>, util::error_code> &record,
+		const std::optional<step> &writer)
+{
+	if (!writer || writer->length == 0U) {
+		const util::error_condition missing{util::errc::no_such_file_or_directory};
+		return !record && (record.error() == missing);
+	}
+	const auto is_value = [&writer](uint8_t byte) { return byte == writer->value; };
+	return record && (record->size() == writer->length) &&
+	       std::ranges::all_of(*record, is_value);
+}
+
+/**
+ * @brief Distribution of the time until the storage was accessible again after a power cut.
+ */
+struct recovery_times {
+	/// Runs by their recovery time: below 2^i microseconds in bucket i.
+	std::array<uint32_t, 24> buckets{};
+	uint32_t count = 0U;
+	uint32_t min_us = UINT32_MAX;
+	uint32_t max_us = 0U;
+	uint64_t total_us = 0U;
+
+	void add(uint32_t us)
+	{
+		size_t bucket = 0U;
+		while ((bucket + 1U < buckets.size()) && (us >= (1U << bucket))) {
+			++bucket;
+		}
+		++buckets[bucket];
+		++count;
+		min_us = std::min(min_us, us);
+		max_us = std::max(max_us, us);
+		total_us += us;
+	}
+
+	void print(const char *name) const
+	{
+		if (count == 0U) {
+			return;
+		}
+
+		TC_PRINT("%s: %u power cuts, recovered in min %u us, mean %u us, max %u us\n", name,
+			 count, min_us, static_cast<uint32_t>(total_us / count), max_us);
+		for (size_t i = 0; i < buckets.size(); ++i) {
+			if (buckets[i] > 0U) {
+				TC_PRINT("  < %u us: %u\n", 1U << i, buckets[i]);
+			}
+		}
+	}
+};
+
+struct workload_size {
+	uint32_t writes;
+	uint32_t erases;
+};
+
+flash_simulator simulator;
+recovery_times write_cuts;
+recovery_times torn_write_cuts;
+recovery_times erase_cuts;
+
+void clear_storage()
+{
+	simulator.power_on();
+	non_volatile_storage storage{};
+	zassert_no_error(storage.init());
+	zassert_no_error(storage.clear());
+}
+
+/**
+ * @brief Mounts the storage after a power cut and checks that no committed step got lost.
+ *
+ * The step that was interrupted may or may not have taken effect.
+ *
+ * @return Microseconds until the storage was accessible again.
+ */
+uint32_t recover(const std::array<std::optional<step>, record_ids + 1U> &committed,
+		 const std::optional<step> &interrupted)
+{
+	non_volatile_storage storage{};
+	std::array<uint8_t, max_record_size> buffer;
+
+	const auto start = k_cycle_get_32();
+	zassert_no_error(storage.init());
+	const auto first_record = storage.read(1U, buffer);
+	const auto recovered_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	for (uint16_t id = 1U; id <= record_ids; ++id) {
+		const auto record = (id == 1U) ? first_record : storage.read(id, buffer);
+		const bool was_interrupted = interrupted && (interrupted->id == id);
+		zassert_true(is_left_by(record, committed[id]) ||
+				     (was_interrupted && is_left_by(record, interrupted)),
+			     "record %u lost", id);
+	}
+
+	return recovered_us;
+}
+
+/**
+ * @brief Runs the workload on a cleared storage until the power gets cut and recovers from it.
+ *
+ * @param write_cut Number of the write (counted from the start of the workload) at which the
+ *                  power gets cut.
+ * @param erases Number of erases (counted from the start of the workload) that are executed.
+ *               The power gets cut at the erase after them.
+ * @param torn Bytes of the cut write that still reach the flash.
+ * @return Whether the workload reached the cut write (otherwise it was cut at the erase before).
+ */
+bool run_with_power_cut(uint32_t write_cut, uint32_t erases, uint32_t torn)
+{
+	clear_storage();
+
+	std::array<std::optional<step>, record_ids + 1U> committed{};
+	std::optional<step> interrupted;
+	bool reached = false;
+	{
+		non_volatile_storage storage{};
+		zassert_no_error(storage.init());
+		(void)storage.read<uint32_t>(1U); // waits for a lazy mount
+
+		const uint32_t write_base = *simulator.write_calls;
+		*simulator.max_write_calls = write_base + write_cut;
+		*simulator.max_len = torn;
+		*simulator.max_erase_calls = *simulator.erase_calls + erases + 1U;
+
+		// the writes and erases after the cut are ignored by the flash, but nvs verifies
+		// its erases: a step fails at an ignored erase of a sector that was not erased
+		for (uint32_t i = 0; i < workload_steps; ++i) {
+			const auto next = workload_step(i);
+			const auto error = execute(storage, next);
+			reached = *simulator.write_calls >= write_base + write_cut;
+			if (error || reached) {
+				interrupted = next;
+				break;
+			}
+			committed[next.id] = next;
+		}
+	}
+
+	simulator.power_on();
+	const auto recovered_us = recover(committed, interrupted);
+	if (!reached) {
+		erase_cuts.add(recovered_us);
+	} else if (torn > 0U) {
+		torn_write_cuts.add(recovered_us);
+	} else {
+		write_cuts.add(recovered_us);
+	}
+	return reached;
+}
+
+/**
+ * @brief Runs the whole workload without a power cut.
+ */
+workload_size measure_workload()
+{
+	clear_storage();
+	non_volatile_storage storage{};
+	zassert_no_error(storage.init());
+	(void)storage.read<uint32_t>(1U);
+
+	const workload_size start{*simulator.write_calls, *simulator.erase_calls};
+	for (uint32_t i = 0; i < workload_steps; ++i) {
+		zassert_no_error(execute(storage, workload_step(i)));
+	}
+	return {*simulator.write_calls - start.writes, *simulator.erase_calls - start.erases};
+}
+
+void *setup(void)
+{
+	simulator = find_flash_simulator();
+	zassert_not_null(simulator.write_calls);
+	zassert_not_null(simulator.erase_calls);
+	zassert_not_null(simulator.max_write_calls);
+	zassert_not_null(simulator.max_erase_calls);
+	zassert_not_null(simulator.max_len);
+	return nullptr;
+}
+
+void teardown(void *)
+{
+	clear_storage();
+}
+
+} // namespace
+
+ZTEST_SUITE(power_loss, NULL, setup, NULL, NULL, teardown);
+
+/**
+ * @brief Cuts the power at every write and erase of a workload that includes garbage
+ *        collections, checks that no committed record got lost and reports the recovery times.
+ *
+ * The erases that precede a write are found by allowing one more erase until the workload
+ * reaches the write: every run that does not reach it got its power cut at an erase instead.
+ * Every write is cut twice, before it reaches the flash and after a few of its bytes.
+ */
+ZTEST(power_loss, test_power_cut_at_every_step)
+{
+	const auto workload = measure_workload();
+	zassert_true(workload.erases > 0U, "the workload does not garbage collect");
+	TC_PRINT("workload of %u steps: %u writes, %u erases\n", workload_steps, workload.writes,
+		 workload.erases);
+
+	uint32_t erases = 0U;
+	for (uint32_t write = 1U; write <= workload.writes; ++write) {
+		while (!run_with_power_cut(write, erases, 0U)) {
+			++erases;
+			zassert_true(erases <= workload.erases);
+		}
+		(void)run_with_power_cut(write, erases, torn_bytes);
+	}
+
+	write_cuts.print("cut before a write");
+	torn_write_cuts.print("cut during a write");
+	erase_cuts.print("cut before an erase");
+}
@@ -0,0 +1,162 @@
+#include "assertions.hpp"
+#include "device_log_messages.hpp"
+#include "protobuf/arena.hpp"
+#include "protobuf/protobuf_message.hpp"
+#include <zephyr/ztest.h>
+#include <algorithm>
+#include <array>
+#include <string_view>
+
+namespace
+{
+
+constexpr size_t maximum_encoded_size = 600U;
+using device_log_message = protobuf::message<DeviceLog, maximum_encoded_size>;
+
+struct payload {
+	std::string_view name;
+	size_t sample_count;
+	std::span<const std::string_view> tags;
+};
+
+constexpr std::array<std::string_view, 2> typical_tags{"ok", "calibrated"};
+constexpr std::array<std::string_view, 8> worst_case_tags{
+	"0123456789abcdef", "0123456789abcdef", "0123456789abcdef", "0123456789abcdef",
+	"0123456789abcdef", "0123456789abcdef", "0123456789abcdef", "0123456789abcdef"};
+
+constexpr payload typical{"sensor-1", 8U, typical_tags};
+constexpr payload worst_case{"0123456789abcdef0123456789abcdef", 64U, worst_case_tags};
+
+uint32_t sample(size_t index)
+{
+	return static_cast<uint32_t>(index * 1000U + 7U);
+}
+
+/**
+ * @brief Encodes the payload, with the encoded elements of the repeated fields in an arena.
+ */
+std::span<uint8_t> encode(const payload &content, std::span<uint8_t> buffer)
+{
+	std::array<uint8_t, 512> memory{};
+	protobuf::arena arena{memory};
+
+	protobuf::string_field name{arena};
+	protobuf::repeated_field<uint32_t> samples{arena};
+	protobuf::repeated_field<std::string_view> tags{arena};
+
+	name.assign(content.name);
+	for (size_t i = 0; i < content.sample_count; ++i) {
+		zassert_true(samples.push_back(sample(i)));
+	}
+	for (const auto tag : content.tags) {
+		zassert_true(tags.push_back(tag));
+	}
+
+	device_log_message message{DeviceLog_msg};
+	message.data().name = name.encoder();
+	message.data().samples = samples.encoder();
+	message.data().tags = tags.encoder();
+	message.data().offset = -12;
+
+	const auto encoded = message.encode(buffer);
+	zassert_true(encoded.has_value());
+	return encoded.value();
+}
+
+/**
+ * @brief Decodes a message into the arena and checks its content.
+ *
+ * @return The error of the decoding.
+ */
+util::error_code decode_and_verify(std::span<const uint8_t> encoded, const payload &content,
+				   protobuf::arena &arena)
+{
+	protobuf::string_field name{arena};
+	protobuf::repeated_field<uint32_t> samples{arena};
+	protobuf::repeated_field<std::string_view> tags{arena};
+
+	device_log_message message{DeviceLog_msg};
+	message.data().name = name.decoder();
+	message.data().samples = samples.decoder();
+	message.data().tags = tags.decoder();
+
+	const auto error = message.decode(encoded);
+	if (error) {
+		return error;
+	}
+
+	zassert_true(name.value() == content.name);
+	zassert_equal(samples.values().size(), content.sample_count);
+	size_t index = 0U;
+	for (const auto value : samples.values()) {
+		zassert_equal(value, sample(index++));
+	}
+	zassert_true(std::ranges::equal(tags.values(), content.tags));
+	zassert_equal(message.data().offset, -12);
+	return {};
+}
+
+} // namespace
+
+ZTEST_SUITE(protobuf_arena, NULL, NULL, NULL, NULL, NULL);
+
+/**
+ * @brief Strings and repeated fields are decoded into the arena and encoded from it.
+ */
+ZTEST(protobuf_arena, test_round_trip)
+{
+	std::array<uint8_t, maximum_encoded_size> buffer{};
+	std::array<uint8_t, 1024> memory{};
+	protobuf::arena arena{memory};
+
+	for (const auto &content : {typical, worst_case}) {
+		const auto encoded = encode(content, buffer);
+		arena.reset();
+		zassert_no_error(decode_and_verify(encoded, content, arena));
+
+		// the wire format is the same as with statically allocated fields
+		protobuf::message<StaticDeviceLog, StaticDeviceLog_size> static_message{
+			StaticDeviceLog_msg};
+		zassert_no_error(static_message.decode(encoded));
+		zassert_true(std::string_view{static_message.data().name} == content.name);
+		zassert_equal(static_message.data().samples_count, content.sample_count);
+		zassert_equal(static_message.data().tags_count, content.tags.size());
+	}
+}
+
+/**
+ * @brief Decoding fails cleanly if the message does not fit into the arena.
+ */
+ZTEST(protobuf_arena, test_arena_exhausted)
+{
+	std::array<uint8_t, maximum_encoded_size> buffer{};
+	const auto encoded = encode(worst_case, buffer);
+
+	std::array<uint8_t, 64> memory{};
+	protobuf::arena arena{memory};
+	zassert_error(decode_and_verify(encoded, worst_case, arena));
+	zassert_true(arena.used() <= arena.capacity());
+}
+
+/**
+ * @brief Compare the memory used for a typical and a worst-case message to static allocation.
+ */
+ZTEST(protobuf_arena, test_memory_use)
+{
+	std::array<uint8_t, maximum_encoded_size> buffer{};
+	std::array<uint8_t, 1024> memory{};
+	protobuf::arena arena{memory};
+
+	size_t used[2]{};
+	size_t index = 0U;
+	for (const auto &content : {typical, worst_case}) {
+		const auto encoded = encode(content, buffer);
+		arena.reset();
+		zassert_no_error(decode_and_verify(encoded, content, arena));
+		used[index++] = sizeof(DeviceLog) + arena.used();
+	}
+
+	TC_PRINT("static allocation: %zu bytes, arena: typical %zu bytes, worst case %zu bytes\n",
+		 sizeof(StaticDeviceLog), used[0], used[1]);
+	zassert_true(used[0] < sizeof(StaticDeviceLog));
+}
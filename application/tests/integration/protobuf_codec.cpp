@@ -0,0 +1,236 @@
+#include "assertions.hpp"
+#include "protobuf/protobuf_message.hpp"
+#include "scalar_types_messages.hpp"
+#include <zephyr/ztest.h>
+#include <algorithm>
+#include <cstring>
+#include <pb_decode.h>
+#include <pb_encode.h>
+
+static_assert(protobuf::codec<ScalarTypes>::available);
+static_assert(!protobuf::codec<MixedTypes>::available, "strings need nanopb");
+
+namespace
+{
+
+constexpr size_t iterations = 100U;
+
+ScalarTypes make_scalar_types()
+{
+	ScalarTypes message = ScalarTypes_init_default;
+	message.flag = true;
+	message.int32_value = -5;
+	message.uint32_value = 4000000000U;
+	message.sint32_value = -300;
+	message.int64_value = -1234567890123;
+	message.uint64_value = UINT64_MAX;
+	message.sint64_value = -9000000000;
+	message.fixed32_value = 7U;
+	message.sfixed32_value = -7;
+	message.float_value = 1.5F;
+	message.fixed64_value = 99U;
+	message.sfixed64_value = -99;
+	message.double_value = -2.25;
+	message.color = Color_COLOR_GREEN;
+	message.large_tag_value = 1U;
+	return message;
+}
+
+bool operator==(const ScalarTypes &lhs, const ScalarTypes &rhs)
+{
+	return (lhs.flag == rhs.flag) && (lhs.int32_value == rhs.int32_value) &&
+	       (lhs.uint32_value == rhs.uint32_value) && (lhs.sint32_value == rhs.sint32_value) &&
+	       (lhs.int64_value == rhs.int64_value) && (lhs.uint64_value == rhs.uint64_value) &&
+	       (lhs.sint64_value == rhs.sint64_value) && (lhs.fixed32_value == rhs.fixed32_value) &&
+	       (lhs.sfixed32_value == rhs.sfixed32_value) && (lhs.float_value == rhs.float_value) &&
+	       (lhs.fixed64_value == rhs.fixed64_value) &&
+	       (lhs.sfixed64_value == rhs.sfixed64_value) &&
+	       (lhs.double_value == rhs.double_value) && (lhs.color == rhs.color) &&
+	       (lhs.large_tag_value == rhs.large_tag_value);
+}
+
+size_t nanopb_encode(const ScalarTypes &message, std::span<uint8_t> buffer)
+{
+	pb_ostream_t stream = pb_ostream_from_buffer(buffer.data(), buffer.size());
+	zassert_true(pb_encode(&stream, &ScalarTypes_msg, &message));
+	return stream.bytes_written;
+}
+
+ScalarTypes nanopb_decode(std::span<const uint8_t> buffer)
+{
+	ScalarTypes message = ScalarTypes_init_default;
+	pb_istream_t stream = pb_istream_from_buffer(buffer.data(), buffer.size());
+	zassert_true(pb_decode(&stream, &ScalarTypes_msg, &message));
+	return message;
+}
+
+struct codec_cycles {
+	uint32_t nanopb_encode;
+	uint32_t codec_encode;
+	uint32_t nanopb_decode;
+	uint32_t codec_decode;
+};
+
+codec_cycles benchmark(const ScalarTypes &message)
+{
+	using codec = protobuf::codec<ScalarTypes>;
+	std::array<uint8_t, ScalarTypes_size> buffer{};
+	size_t size = 0U;
+	codec_cycles cycles{};
+
+	auto start = k_cycle_get_32();
+	for (size_t i = 0; i < iterations; ++i) {
+		size = nanopb_encode(message, buffer);
+	}
+	cycles.nanopb_encode = (k_cycle_get_32() - start) / iterations;
+
+	start = k_cycle_get_32();
+	for (size_t i = 0; i < iterations; ++i) {
+		zassert_true(codec::encode(message, buffer).has_value());
+	}
+	cycles.codec_encode = (k_cycle_get_32() - start) / iterations;
+
+	const auto encoded = std::span<const uint8_t>{buffer}.first(size);
+	start = k_cycle_get_32();
+	for (size_t i = 0; i < iterations; ++i) {
+		(void)nanopb_decode(encoded);
+	}
+	cycles.nanopb_decode = (k_cycle_get_32() - start) / iterations;
+
+	ScalarTypes decoded{};
+	start = k_cycle_get_32();
+	for (size_t i = 0; i < iterations; ++i) {
+		zassert_no_error(codec::decode(encoded, decoded));
+	}
+	cycles.codec_decode = (k_cycle_get_32() - start) / iterations;
+
+	return cycles;
+}
+
+} // namespace
+
+ZTEST_SUITE(protobuf_codec, NULL, NULL, NULL, NULL, NULL);
+
+/**
+ * @brief The scalar codec produces the same bytes as nanopb and reads what nanopb writes.
+ */
+ZTEST(protobuf_codec, test_wire_compatibility)
+{
+	using codec = protobuf::codec<ScalarTypes>;
+	std::array<uint8_t, ScalarTypes_size> nanopb_buffer{};
+	std::array<uint8_t, ScalarTypes_size> codec_buffer{};
+
+	for (const auto &message : {ScalarTypes(ScalarTypes_init_default), make_scalar_types()}) {
+		const auto size = nanopb_encode(message, nanopb_buffer);
+		const auto encoded = codec::encode(message, codec_buffer);
+		zassert_true(encoded.has_value());
+		zassert_true(std::ranges::equal(encoded.value(),
+						std::span{nanopb_buffer}.first(size)));
+
+		ScalarTypes decoded{};
+		zassert_no_error(codec::decode(std::span{nanopb_buffer}.first(size), decoded));
+		zassert_true(decoded == message);
+		zassert_true(nanopb_decode(encoded.value()) == message);
+	}
+
+	// buffers that are too small and truncated messages fail like with nanopb
+	const auto message = make_scalar_types();
+	const auto size = nanopb_encode(message, nanopb_buffer);
+	zassert_false(codec::encode(message, std::span{codec_buffer}.first(size - 1U)).has_value());
+	ScalarTypes decoded{};
+	zassert_error(codec::decode(std::span{nanopb_buffer}.first(size - 1U), decoded));
+}
+
+/**
+ * @brief The scalar codec accepts and rejects the same edge cases of the wire format as nanopb and
+ *        decodes the accepted ones to the same message.
+ */
+ZTEST(protobuf_codec, test_decode_like_nanopb)
+{
+	using codec = protobuf::codec<ScalarTypes>;
+	const std::initializer_list<std::initializer_list<uint8_t>> inputs = {
+		// int32 with more than 32 bits (truncated) and uint32 out of range
+		{0x10, 0x80, 0x80, 0x80, 0x80, 0x10},
+		{0x18, 0x80, 0x80, 0x80, 0x80, 0x10},
+		// sint32 out of range
+		{0x20, 0x80, 0x80, 0x80, 0x80, 0x10},
+		// zero tag, also after a field
+		{0x00, 0x00},
+		{0x08, 0x01, 0x00},
+		// booleans padded with zeros and wider than 32 bits
+		{0x08, 0x81, 0x80, 0x80, 0x80, 0x80, 0x00},
+		{0x08, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01},
+		// enum values without an enumerator
+		{0x70, 0x20},
+		{0x70, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01},
+		// unknown varint longer than 10 bytes and the tenth byte of a varint overflowing
+		{0xA0, 0x01, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+		 0x00},
+		{0x28, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x02},
+		// wrong wire type, truncated key and unknown field longer than the message
+		{0x0D, 0x01, 0x00, 0x00, 0x00},
+		{0x80},
+		{0xA2, 0x01, 0x05, 0x00},
+	};
+
+	for (size_t i = 0; i < inputs.size(); ++i) {
+		const std::span<const uint8_t> input{std::data(inputs)[i]};
+
+		ScalarTypes by_nanopb = ScalarTypes_init_default;
+		pb_istream_t stream = pb_istream_from_buffer(input.data(), input.size());
+		const bool nanopb_accepted = pb_decode(&stream, &ScalarTypes_msg, &by_nanopb);
+
+		ScalarTypes by_codec{};
+		const bool codec_accepted = !codec::decode(input, by_codec);
+		zassert_equal(codec_accepted, nanopb_accepted, "input %zu", i);
+		if (!nanopb_accepted) {
+			continue;
+		}
+
+		// compared as encoded by nanopb, as the enums may hold values without an enumerator
+		std::array<uint8_t, ScalarTypes_size> nanopb_buffer{};
+		std::array<uint8_t, ScalarTypes_size> codec_buffer{};
+		const auto nanopb_size = nanopb_encode(by_nanopb, nanopb_buffer);
+		const auto codec_size = nanopb_encode(by_codec, codec_buffer);
+		zassert_true(std::ranges::equal(std::span{nanopb_buffer}.first(nanopb_size),
+						std::span{codec_buffer}.first(codec_size)),
+			     "input %zu", i);
+	}
+}
+
+/**
+ * @brief Messages with fields that are not scalar fall back to nanopb.
+ */
+ZTEST(protobuf_codec, test_fallback_to_nanopb)
+{
+	protobuf::message<MixedTypes, MixedTypes_size> message{MixedTypes_msg};
+	message.data().id = 3U;
+	std::strcpy(message.data().name, "example");
+
+	std::array<uint8_t, MixedTypes_size> buffer{};
+	const auto encoded = message.encode(buffer);
+	zassert_true(encoded.has_value());
+
+	protobuf::message<MixedTypes, MixedTypes_size> decoded{MixedTypes_msg};
+	zassert_no_error(decoded.decode(encoded.value()));
+	zassert_equal(decoded.data().id, 3U);
+	zassert_str_equal(decoded.data().name, "example");
+}
+
+/**
+ * @brief Compare the cycles of nanopb and the scalar codec for a full and a single field message.
+ */
+ZTEST(protobuf_codec, test_benchmark_codec)
+{
+	ScalarTypes single_field = ScalarTypes_init_default;
+	single_field.uint32_value = 42U;
+
+	for (const auto &[name, message] :
+	     {std::pair{"all fields", make_scalar_types()}, std::pair{"one field", single_field}}) {
+		const auto cycles = benchmark(message);
+		TC_PRINT("%-10s: encode nanopb %u / codec %u cycles, decode nanopb %u / codec %u "
+			 "cycles\n",
+			 name, cycles.nanopb_encode, cycles.codec_encode, cycles.nanopb_decode,
+			 cycles.codec_decode);
+	}
+}
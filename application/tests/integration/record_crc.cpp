@@ -0,0 +1,224 @@
+#include "assertions.hpp"
+#include "storage/non_volatile_storage.hpp"
+#include "storage/scrubber.hpp"
+#include "util/crc32.hpp"
+#include <zephyr/ztest.h>
+
+namespace
+{
+
+constexpr size_t iterations = 100U;
+
+template <size_t size>
+std::array<uint8_t, size> make_data(uint8_t seed)
+{
+	std::array<uint8_t, size> data{};
+	for (size_t i = 0; i < data.size(); ++i) {
+		data[i] = static_cast<uint8_t>(seed + i * 37U);
+	}
+	return data;
+}
+
+template <size_t size>
+void benchmark_crc()
+{
+	const auto data = make_data<size>(1U);
+	uint32_t table_checksum = 0U;
+	uint32_t slice_by_8_checksum = 0U;
+
+	auto start = k_cycle_get_32();
+	for (size_t i = 0; i < iterations; ++i) {
+		table_checksum += util::crc32::calculate(data);
+	}
+	const uint32_t table_cycles = (k_cycle_get_32() - start) / iterations;
+
+	start = k_cycle_get_32();
+	for (size_t i = 0; i < iterations; ++i) {
+		slice_by_8_checksum += util::crc32::calculate_slice_by_8(data);
+	}
+	const uint32_t slice_by_8_cycles = (k_cycle_get_32() - start) / iterations;
+
+	// the accumulated checksums keep the calculations from being optimized away
+	zassert_equal(util::crc32::calculate(data), util::crc32::calculate_slice_by_8(data));
+	zassert_equal(table_checksum, slice_by_8_checksum);
+	TC_PRINT("%3zu bytes: table %u cycles, slice-by-8 %u cycles\n", size, table_cycles,
+		 slice_by_8_cycles);
+}
+
+struct corruption_report {
+	uint16_t id;
+	util::error_code error;
+};
+
+corruption_report last_report{};
+size_t report_count = 0U;
+
+void report_corruption(uint16_t id, util::error_code error)
+{
+	last_report = {id, error};
+	report_count++;
+}
+
+} // namespace
+
+ZTEST_SUITE(record_crc, NULL, NULL, NULL, NULL, NULL);
+
+/**
+ * @brief Compare the table-driven and the slice-by-8 CRC calculation for typical record sizes.
+ */
+ZTEST(record_crc, test_benchmark_crc)
+{
+	benchmark_crc<16U>();
+	benchmark_crc<64U>();
+	benchmark_crc<256U>();
+}
+
+/**
+ * @brief Measure the share of the CRC verification in reading a record.
+ */
+ZTEST(record_crc, test_benchmark_read_overhead)
+{
+	constexpr uint16_t id = 3U;
+	const auto data = make_data<64U>(2U);
+
+	non_volatile_storage storage{};
+	zassert_no_error(storage.init());
+	zassert_no_error(storage.clear());
+	zassert_no_error(storage.init());
+	zassert_no_error(storage.write(id, std::span<const uint8_t>{data}));
+
+	auto start = k_cycle_get_32();
+	for (size_t i = 0; i < iterations; ++i) {
+		const auto record = storage.read<std::array<uint8_t, 64U>>(id);
+		zassert_true(record.has_value());
+	}
+	const uint32_t read_cycles = (k_cycle_get_32() - start) / iterations;
+
+	start = k_cycle_get_32();
+	for (size_t i = 0; i < iterations; ++i) {
+		(void)storage::record_crc::calculate(data);
+	}
+	const uint32_t verify_cycles = (k_cycle_get_32() - start) / iterations;
+
+	TC_PRINT("64 byte read: %u cycles, thereof CRC verification %u cycles\n", read_cycles,
+		 verify_cycles);
+
+	zassert_no_error(storage.clear());
+}
+
+/**
+ * @brief Corrupted records fail to be read and are found by the scrubber.
+ */
+ZTEST(record_crc, test_corruption_is_detected)
+{
+	constexpr uint16_t intact_id = 1U;
+	constexpr uint16_t corrupted_id = 2U;
+	using record = std::array<uint8_t, 32U>;
+	const record data = make_data<32U>(3U);
+
+	static basic_non_volatile_storage<storage::ram_backend> storage{};
+	zassert_no_error(storage.init());
+	zassert_no_error(storage.clear());
+	zassert_no_error(storage.write(intact_id, std::span<const uint8_t>{data}));
+	zassert_no_error(storage.write(corrupted_id, std::span<const uint8_t>{data}));
+
+	static storage::scrubber<storage::ram_backend> scrubber{storage, report_corruption};
+	report_count = 0U;
+	auto corruptions = scrubber.scrub(1024U);
+	zassert_true(corruptions.has_value());
+	zassert_equal(corruptions.value(), 0U);
+	zassert_equal(report_count, 0U);
+
+	// flip a bit of the stored data behind the back of the storage
+	{
+		const auto view = storage.view(corrupted_id);
+		zassert_true(view.has_value());
+		const_cast<uint8_t *>(view->data().data())[5] ^= 0x10U;
+	}
+
+	const auto corrupted = storage.read<record>(corrupted_id);
+	zassert_false(corrupted.has_value());
+	zassert_equal(corrupted.error(), util::error_code{storage_error_code::checksum_mismatch});
+	zassert_true(storage.read<record>(intact_id).has_value());
+
+	corruptions = scrubber.scrub(1024U);
+	zassert_true(corruptions.has_value());
+	zassert_equal(corruptions.value(), 1U);
+	zassert_equal(report_count, 1U);
+	zassert_equal(last_report.id, corrupted_id);
+	zassert_equal(last_report.error, util::error_code{storage_error_code::checksum_mismatch});
+
+	// overwriting the record repairs it
+	zassert_no_error(storage.write(corrupted_id, std::span<const uint8_t>{data}));
+	zassert_true(storage.read<record>(corrupted_id).has_value());
+
+	zassert_no_error(storage.clear());
+}
+
+/**
+ * @brief The scrubber does not read more bytes per second than configured.
+ */
+ZTEST(record_crc, test_scrubber_rate_limit)
+{
+	constexpr uint32_t bytes_per_second = 640U;
+	constexpr uint16_t records = 5U;
+	const auto data = make_data<64U>(4U);
+
+	static basic_non_volatile_storage<storage::ram_backend> storage{};
+	zassert_no_error(storage.init());
+	zassert_no_error(storage.clear());
+	for (uint16_t id = 1; id <= records; ++id) {
+		zassert_no_error(storage.write(id, std::span<const uint8_t>{data}));
+	}
+
+	static storage::scrubber<storage::ram_backend> scrubber{storage, report_corruption};
+	const auto start = k_uptime_get();
+	const auto corruptions = scrubber.scrub(bytes_per_second);
+	const auto elapsed_ms = k_uptime_get() - start;
+
+	zassert_true(corruptions.has_value());
+	zassert_equal(corruptions.value(), 0U);
+	const int64_t expected_ms = (records * data.size() * 1000U) / bytes_per_second;
+	zassert_true(elapsed_ms >= expected_ms - 10);
+
+	zassert_no_error(storage.clear());
+}
+
+/**
+ * @brief The scrubber also verifies the records beyond the first CONFIG_APP_STORAGE_MAX_RECORDS.
+ */
+ZTEST(record_crc, test_scrubber_pages)
+{
+	constexpr uint16_t records = CONFIG_APP_STORAGE_MAX_RECORDS + 20U;
+	if (records > CONFIG_APP_STORAGE_RAM_BACKEND_MAX_RECORDS) {
+		ztest_test_skip();
+	}
+	const auto data = make_data<4U>(5U);
+
+	static basic_non_volatile_storage<storage::ram_backend> storage{};
+	zassert_no_error(storage.init());
+	zassert_no_error(storage.clear());
+	// IDs spread over the whole range, so that the pages have different widths
+	const auto id_of = [](uint16_t index) { return static_cast<uint16_t>(index * 401U); };
+	for (uint16_t index = 0; index < records; ++index) {
+		zassert_no_error(storage.write(id_of(index), std::span<const uint8_t>{data}));
+	}
+
+	// corrupt the record with the highest ID, which is not in the first page
+	const uint16_t corrupted_id = id_of(records - 1U);
+	{
+		const auto view = storage.view(corrupted_id);
+		zassert_true(view.has_value());
+		const_cast<uint8_t *>(view->data().data())[1] ^= 0x01U;
+	}
+
+	static storage::scrubber<storage::ram_backend> scrubber{storage, report_corruption};
+	report_count = 0U;
+	const auto corruptions = scrubber.scrub(UINT32_MAX);
+	zassert_true(corruptions.has_value());
+	zassert_equal(corruptions.value(), 1U);
+	zassert_equal(report_count, 1U);
+	zassert_equal(last_report.id, corrupted_id);
+
+	zassert_no_error(storage.clear());
+}
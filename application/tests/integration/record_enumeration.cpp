@@ -0,0 +1,163 @@
+#include "assertions.hpp"
+#include "storage/non_volatile_storage.hpp"
+#include "util/static_vector.hpp"
+#include <zephyr/ztest.h>
+#include <algorithm>
+
+namespace
+{
+
+constexpr uint16_t probed_ids = 1024U;
+constexpr uint16_t benchmark_records = 16U;
+
+/// Value of a record, derived from its ID.
+constexpr uint32_t value_of(uint16_t id)
+{
+	return id * 3U + 1U;
+}
+
+struct visited {
+	uint16_t id;
+	size_t length;
+	uint32_t value;
+
+	friend bool operator==(const visited &, const visited &) = default;
+};
+
+using visited_list = util::static_vector<visited, 8>;
+
+/**
+ * @brief Collects the visited records in the range, sorted by ID.
+ */
+template <storage::backend backend_type>
+visited_list enumerate(basic_non_volatile_storage<backend_type> &storage, storage::id_range range)
+{
+	visited_list records;
+	zassert_no_error(storage.for_each(range, [&storage, &records](const auto &entry) {
+		uint32_t value = 0U;
+		if (entry.data) {
+			zassert_equal(entry.data->size(), entry.length);
+			std::copy_n(entry.data->begin(), std::min(entry.length, sizeof(value)),
+				    reinterpret_cast<uint8_t *>(&value));
+		} else {
+			value = storage.template read<uint32_t>(entry.id).value_or(0U);
+		}
+		zassert_true(records.push_back({entry.id, entry.length, value}));
+		return true;
+	}));
+
+	std::ranges::sort(records, {}, &visited::id);
+	return records;
+}
+
+template <storage::backend backend_type>
+void test_enumeration()
+{
+	basic_non_volatile_storage<backend_type> storage{};
+	zassert_no_error(storage.init());
+	zassert_no_error(storage.clear());
+	zassert_no_error(storage.init());
+
+	for (const uint16_t id : {3U, 10U, 11U, 12U, 500U, 1000U}) {
+		zassert_no_error(storage.template write<uint32_t>(id, value_of(id)));
+	}
+	// only the most recent data is visited and deleted records are not visited at all
+	zassert_no_error(storage.template write<uint32_t>(11U, 7U));
+	zassert_no_error(storage.write(12U, std::span<const uint8_t>{}));
+
+	const visited_list all{{3U, 4U, value_of(3U)},
+			       {10U, 4U, value_of(10U)},
+			       {11U, 4U, 7U},
+			       {500U, 4U, value_of(500U)},
+			       {1000U, 4U, value_of(1000U)}};
+	zassert_true(enumerate(storage, {}) == all);
+
+	const visited_list range{
+		{10U, 4U, value_of(10U)}, {11U, 4U, 7U}, {500U, 4U, value_of(500U)}};
+	zassert_true(enumerate(storage, {10U, 500U}) == range);
+	zassert_true(enumerate(storage, {1001U, UINT16_MAX}).empty());
+
+	// the walk stops as soon as the visitor returns false
+	size_t count = 0U;
+	zassert_no_error(storage.for_each([&count](const storage::record_entry &) {
+		++count;
+		return false;
+	}));
+	zassert_equal(count, 1U);
+
+	zassert_no_error(storage.clear());
+}
+
+/**
+ * @brief Cycles to find the stored records among the first IDs, by probing every ID with a read
+ *        and by enumerating the range.
+ */
+template <storage::backend backend_type>
+void benchmark_enumeration(const char *name)
+{
+	basic_non_volatile_storage<backend_type> storage{};
+	zassert_no_error(storage.init());
+	zassert_no_error(storage.clear());
+	zassert_no_error(storage.init());
+
+	for (uint16_t i = 0; i < benchmark_records; ++i) {
+		const auto id = static_cast<uint16_t>(i * (probed_ids / benchmark_records));
+		zassert_no_error(storage.template write<uint32_t>(id, value_of(id)));
+	}
+
+	size_t probed_count = 0U;
+	auto start = k_cycle_get_32();
+	for (uint16_t id = 0; id < probed_ids; ++id) {
+		if (storage.template read<uint32_t>(id).has_value()) {
+			++probed_count;
+		}
+	}
+	const uint32_t probe_cycles = k_cycle_get_32() - start;
+
+	size_t enumerated_count = 0U;
+	start = k_cycle_get_32();
+	zassert_no_error(storage.for_each({0U, probed_ids - 1U},
+					  [&enumerated_count](const storage::record_entry &) {
+						  ++enumerated_count;
+						  return true;
+					  }));
+	const uint32_t enumerate_cycles = k_cycle_get_32() - start;
+
+	zassert_equal(probed_count, benchmark_records);
+	zassert_equal(enumerated_count, benchmark_records);
+	TC_PRINT("%s: %u records among %u IDs found in %u cycles by probing, in %u cycles by "
+		 "enumeration\n",
+		 name, benchmark_records, probed_ids, probe_cycles, enumerate_cycles);
+
+	zassert_no_error(storage.clear());
+}
+
+} // namespace
+
+ZTEST_SUITE(record_enumeration, NULL, NULL, NULL, NULL, NULL);
+
+/**
+ * @brief Enumeration of all records and of ID ranges with the RAM backend.
+ */
+ZTEST(record_enumeration, test_ram_backend)
+{
+	test_enumeration<storage::ram_backend>();
+}
+
+/**
+ * @brief Enumeration in a single walk over the allocation table of the nvs backend.
+ */
+ZTEST(record_enumeration, test_nvs_backend)
+{
+	test_enumeration<storage::nvs_backend>();
+}
+
+/**
+ * @brief Enumeration takes time proportional to the stored records, probing all IDs of a range
+ *        takes time proportional to the range (with a search of the records for every ID).
+ */
+ZTEST(record_enumeration, test_benchmark_probing)
+{
+	benchmark_enumeration<storage::ram_backend>("ram");
+	benchmark_enumeration<storage::nvs_backend>("nvs");
+}
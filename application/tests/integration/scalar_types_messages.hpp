@@ -0,0 +1,12 @@
+#ifndef TESTS_INTEGRATION_SCALAR_TYPES_MESSAGES_HPP
+#define TESTS_INTEGRATION_SCALAR_TYPES_MESSAGES_HPP
+
+#include "protobuf/scalar_codec.hpp"
+#include "protobuf/scalar_types.pb.h"
+
+// Codecs of the messages of scalar_types.proto, included instead of scalar_types.pb.h (see
+// protobuf/storage_messages.hpp).
+PROTOBUF_SCALAR_CODEC(ScalarTypes);
+PROTOBUF_SCALAR_CODEC(MixedTypes);
+
+#endif /* TESTS_INTEGRATION_SCALAR_TYPES_MESSAGES_HPP */
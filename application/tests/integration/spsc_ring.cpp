@@ -0,0 +1,143 @@
+#include "os/spsc_ring.hpp"
+#include <zephyr/ztest.h>
+#include <array>
+#include <numeric>
+
+namespace
+{
+
+constexpr size_t isr_samples = 100U;
+constexpr uint32_t benchmark_elements = 1024U;
+constexpr size_t benchmark_batch = 16U;
+
+using sample_ring = os::spsc_ring<uint32_t, 16U, true>;
+
+struct isr_producer {
+	sample_ring ring;
+	uint32_t next_sample;
+	uint32_t dropped;
+};
+
+isr_producer producer{};
+
+void produce_sample(struct k_timer *)
+{
+	// executed in the timer ISR
+	if (producer.ring.push(producer.next_sample)) {
+		producer.next_sample++;
+	} else {
+		producer.dropped++;
+	}
+}
+
+K_TIMER_DEFINE(sample_timer, produce_sample, NULL);
+
+K_MSGQ_DEFINE(benchmark_queue, sizeof(uint32_t), benchmark_elements, alignof(uint32_t));
+os::spsc_ring<uint32_t, benchmark_elements> benchmark_ring;
+
+} // namespace
+
+ZTEST_SUITE(spsc_ring, NULL, NULL, NULL, NULL, NULL);
+
+/**
+ * @brief Elements are returned in order, also for batches that wrap around the end of the buffer.
+ */
+ZTEST(spsc_ring, test_batches)
+{
+	os::spsc_ring<uint32_t, 8U> ring;
+	std::array<uint32_t, 5> input{};
+	std::array<uint32_t, 8> output{};
+
+	uint32_t next_input = 0U;
+	uint32_t next_output = 0U;
+	for (size_t round = 0; round < 10U; ++round) {
+		std::iota(input.begin(), input.end(), next_input);
+		next_input += ring.push(input);
+
+		const size_t count = ring.pop(std::span{output}.first(3U));
+		for (size_t i = 0; i < count; ++i) {
+			zassert_equal(output[i], next_output++);
+		}
+	}
+
+	// all of the capacity is usable
+	while (ring.push(next_input)) {
+		next_input++;
+	}
+	zassert_equal(ring.size(), ring.capacity);
+	zassert_equal(ring.pop(output), ring.capacity);
+	zassert_true(ring.empty());
+	for (const auto element : output) {
+		zassert_equal(element, next_output++);
+	}
+	zassert_equal(next_output, next_input);
+}
+
+/**
+ * @brief A timer ISR produces samples, which the test thread consumes waiting on the semaphore.
+ */
+ZTEST(spsc_ring, test_isr_producer)
+{
+	k_timer_start(&sample_timer, K_MSEC(1), K_MSEC(1));
+
+	uint32_t expected = 0U;
+	std::array<uint32_t, 4> samples{};
+	while (expected < isr_samples) {
+		const size_t count = producer.ring.pop_wait(samples, K_MSEC(100));
+		zassert_not_equal(count, 0U, "no sample within the timeout");
+
+		for (size_t i = 0; i < count; ++i) {
+			zassert_equal(samples[i], expected++);
+		}
+	}
+
+	k_timer_stop(&sample_timer);
+	zassert_equal(producer.dropped, 0U);
+
+	// nothing arrives after the timer was stopped
+	uint32_t sample = 0U;
+	while (producer.ring.pop(sample)) {
+	}
+	zassert_false(producer.ring.pop_wait(sample, K_MSEC(10)));
+}
+
+/**
+ * @brief Cycles per element of the ring compared to k_msgq.
+ */
+ZTEST(spsc_ring, test_benchmark_throughput)
+{
+	uint32_t element = 0U;
+
+	auto start = k_cycle_get_32();
+	for (uint32_t i = 0; i < benchmark_elements; ++i) {
+		zassert_ok(k_msgq_put(&benchmark_queue, &i, K_NO_WAIT));
+	}
+	for (uint32_t i = 0; i < benchmark_elements; ++i) {
+		zassert_ok(k_msgq_get(&benchmark_queue, &element, K_NO_WAIT));
+	}
+	const uint32_t msgq_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < benchmark_elements; ++i) {
+		zassert_true(benchmark_ring.push(i));
+	}
+	for (uint32_t i = 0; i < benchmark_elements; ++i) {
+		zassert_true(benchmark_ring.pop(element));
+	}
+	const uint32_t ring_cycles = k_cycle_get_32() - start;
+
+	std::array<uint32_t, benchmark_batch> batch{};
+	start = k_cycle_get_32();
+	for (size_t i = 0; i < benchmark_elements; i += batch.size()) {
+		zassert_equal(benchmark_ring.push(batch), batch.size());
+	}
+	for (size_t i = 0; i < benchmark_elements; i += batch.size()) {
+		zassert_equal(benchmark_ring.pop(batch), batch.size());
+	}
+	const uint32_t batch_cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("cycles per element (push and pop): k_msgq %u, spsc_ring %u, spsc_ring batch of "
+		 "%zu %u\n",
+		 msgq_cycles / benchmark_elements, ring_cycles / benchmark_elements,
+		 benchmark_batch, batch_cycles / benchmark_elements);
+}
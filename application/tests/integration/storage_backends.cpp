@@ -0,0 +1,99 @@
+#include "assertions.hpp"
+#include "storage/non_volatile_storage.hpp"
+#include <zephyr/ztest.h>
+
+namespace
+{
+
+constexpr uint16_t record_count = 16U;
+constexpr size_t record_size = 24U;
+constexpr size_t update_rounds = 8U;
+
+using record = std::array<uint8_t, record_size>;
+
+record make_record(uint16_t id, size_t round)
+{
+	record data{};
+	for (size_t i = 0; i < data.size(); ++i) {
+		data[i] = static_cast<uint8_t>(id + round + i);
+	}
+	return data;
+}
+
+struct workload_cycles {
+	uint32_t write;
+	uint32_t read;
+	uint32_t update;
+};
+
+/**
+ * @brief Runs the same workload of initial writes, reads and updates on a storage backend.
+ *
+ * All read data is compared against the written data, so that the workload also verifies the
+ * functionality of the backend.
+ */
+template <storage::backend backend_type>
+workload_cycles run_workload()
+{
+	basic_non_volatile_storage<backend_type> storage{};
+	zassert_no_error(storage.init());
+	zassert_no_error(storage.clear());
+	zassert_no_error(storage.init());
+
+	workload_cycles cycles{};
+
+	auto start = k_cycle_get_32();
+	for (uint16_t id = 1; id <= record_count; ++id) {
+		zassert_no_error(storage.write(id, make_record(id, 0)));
+	}
+	cycles.write = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (uint16_t id = 1; id <= record_count; ++id) {
+		const auto data = storage.template read<record>(id);
+		zassert_true(data.has_value());
+		zassert_true(data.value() == make_record(id, 0));
+	}
+	cycles.read = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (size_t round = 1; round <= update_rounds; ++round) {
+		for (uint16_t id = 1; id <= record_count; ++id) {
+			zassert_no_error(storage.write(id, make_record(id, round)));
+		}
+	}
+	cycles.update = k_cycle_get_32() - start;
+
+	for (uint16_t id = 1; id <= record_count; ++id) {
+		const auto data = storage.template read<record>(id);
+		zassert_true(data.has_value());
+		zassert_true(data.value() == make_record(id, update_rounds));
+	}
+
+	zassert_no_error(storage.clear());
+	return cycles;
+}
+
+template <storage::backend backend_type>
+void benchmark(const char *name)
+{
+	const auto cycles = run_workload<backend_type>();
+	TC_PRINT("%-4s: %u writes %u cycles, %u reads %u cycles, %zu updates %u cycles\n", name,
+		 record_count, cycles.write, record_count, cycles.read,
+		 record_count * update_rounds, cycles.update);
+}
+
+} // namespace
+
+ZTEST_SUITE(storage_backends, NULL, NULL, NULL, NULL, NULL);
+
+/**
+ * @brief Benchmark the same workload against every available storage backend.
+ */
+ZTEST(storage_backends, test_benchmark_backends)
+{
+	benchmark<storage::ram_backend>("ram");
+#ifdef CONFIG_NVS
+	benchmark<storage::nvs_backend>("nvs");
+#endif
+}
@@ -0,0 +1,209 @@
+#include "assertions.hpp"
+#include "storage/non_volatile_storage.hpp"
+#include "util/static_vector.hpp"
+#include <zephyr/ztest.h>
+
+namespace
+{
+
+constexpr uint32_t benchmark_iterations = 50U;
+constexpr uint16_t benchmark_id = 100U;
+
+/**
+ * @brief Records the changes a subscriber got notified about.
+ */
+struct recorder {
+	util::static_vector<storage::change, 8> changes;
+	uint32_t last_cycles = 0U;
+	struct k_sem received;
+
+	recorder()
+	{
+		k_sem_init(&received, 0, K_SEM_MAX_LIMIT);
+	}
+
+	storage::change_callback callback()
+	{
+		return [this](const storage::change &change) {
+			last_cycles = k_cycle_get_32();
+			changes.push_back(change);
+			k_sem_give(&received);
+		};
+	}
+
+	void wait(size_t count)
+	{
+		for (size_t i = 0; i < count; ++i) {
+			zassert_ok(k_sem_take(&received, K_SECONDS(1)));
+		}
+	}
+};
+
+void clear_storage()
+{
+	// with its own instance, whose destruction waits for the dispatch of the clear, so that it
+	// is not notified to the subscribers of the tests
+	non_volatile_storage storage{};
+	zassert_no_error(storage.init());
+	zassert_no_error(storage.clear());
+}
+
+/**
+ * @brief Average cycles from the start of a write to the notification of the subscriber.
+ */
+uint32_t measure_propagation(non_volatile_storage &storage, recorder &subscriber)
+{
+	uint32_t total_cycles = 0U;
+	for (uint32_t i = 0; i < benchmark_iterations; ++i) {
+		const auto start = k_cycle_get_32();
+		zassert_no_error(storage.write<uint32_t>(benchmark_id, i));
+		subscriber.wait(1U);
+		total_cycles += subscriber.last_cycles - start;
+		subscriber.changes.clear();
+	}
+	return total_cycles / benchmark_iterations;
+}
+
+} // namespace
+
+ZTEST_SUITE(storage_notifications, NULL, NULL, NULL, NULL, NULL);
+
+/**
+ * @brief Subscribers get notified about the changes of their IDs only (and about clearing), also
+ *        if the changes are made through another instance of the storage.
+ */
+ZTEST(storage_notifications, test_subscriptions)
+{
+	clear_storage();
+
+	// declared before the storage, so that they outlive its subscriptions
+	recorder single;
+	recorder range;
+	recorder overlapping;
+	struct {
+		non_volatile_storage *storage;
+		uint32_t value;
+		struct k_sem done;
+	} reader{nullptr, 0U, {}};
+
+	non_volatile_storage storage{};
+	zassert_no_error(storage.init());
+	zassert_true(storage.subscribe(5U, single.callback()).has_value());
+	zassert_true(storage.subscribe(10U, 19U, range.callback()).has_value());
+	zassert_true(storage.subscribe(3U, 12U, overlapping.callback()).has_value());
+
+	zassert_no_error(storage.write<uint32_t>(5U, 1U));
+	zassert_no_error(storage.write<uint32_t>(12U, 2U));
+	zassert_no_error(storage.write<uint32_t>(30U, 3U)); // no subscriber
+	zassert_no_error(storage.write(12U, std::span<const uint8_t>{}));
+	zassert_no_error(storage.clear());
+	zassert_no_error(storage.init()); // nvs needs to be mounted again after clearing
+
+	single.wait(2U);
+	range.wait(3U);
+	overlapping.wait(4U);
+
+	using enum storage::change_kind;
+	const decltype(single.changes) single_changes{{5U, written}, {0U, cleared}};
+	const decltype(range.changes) range_changes{{12U, written}, {12U, deleted}, {0U, cleared}};
+	const decltype(overlapping.changes) overlapping_changes{
+		{5U, written}, {12U, written}, {12U, deleted}, {0U, cleared}};
+	zassert_true(single.changes == single_changes);
+	zassert_true(range.changes == range_changes);
+	zassert_true(overlapping.changes == overlapping_changes);
+
+	// the instances share the notifier of the storage partition
+	{
+		non_volatile_storage other{};
+		zassert_no_error(other.init());
+		zassert_no_error(other.write<uint32_t>(15U, 4U));
+	}
+	range.wait(1U);
+	zassert_true((range.changes.back() == storage::change{15U, written}));
+	zassert_equal(k_sem_count_get(&single.received), 0U);
+
+	// the new value can be read in the notification
+	reader.storage = &storage;
+	k_sem_init(&reader.done, 0, 1);
+
+	const auto read_value = [&reader](const storage::change &change) {
+		reader.value = reader.storage->read<uint32_t>(change.id).value_or(0U);
+		k_sem_give(&reader.done);
+	};
+	zassert_true(storage.subscribe(40U, read_value).has_value());
+	zassert_no_error(storage.write<uint32_t>(40U, 42U));
+	zassert_ok(k_sem_take(&reader.done, K_SECONDS(1)));
+	zassert_equal(reader.value, 42U);
+}
+
+ZTEST(storage_notifications, test_unsubscribe_and_capacity)
+{
+	recorder subscriber;
+	non_volatile_storage storage{};
+	zassert_no_error(storage.init());
+
+	const auto invalid = storage.subscribe(20U, 10U, subscriber.callback());
+	zassert_false(invalid.has_value());
+	zassert_true(invalid.error() == util::error_condition{util::errc::invalid_argument});
+
+	util::static_vector<storage::subscription_id, CONFIG_APP_STORAGE_MAX_SUBSCRIPTIONS> ids;
+	while (!ids.full()) {
+		const auto id = storage.subscribe(static_cast<uint16_t>(ids.size()),
+						  subscriber.callback());
+		zassert_true(id.has_value());
+		ids.push_back(id.value());
+	}
+
+	const auto exceeding = storage.subscribe(1000U, subscriber.callback());
+	zassert_false(exceeding.has_value());
+	zassert_true(exceeding.error() == util::error_condition{util::errc::not_enough_memory});
+
+	// after unsubscribing, the ID is not notified anymore and the subscription can be reused
+	storage.unsubscribe(ids[0]);
+	zassert_true(storage.subscribe(1000U, subscriber.callback()).has_value());
+
+	zassert_no_error(storage.write<uint32_t>(0U, 1U));
+	zassert_no_error(storage.write<uint32_t>(1000U, 1U));
+	subscriber.wait(1U);
+	zassert_equal(subscriber.changes.size(), 1U);
+	zassert_equal(subscriber.changes[0].id, 1000U);
+}
+
+/**
+ * @brief Cycles from a write to the notification, with only the notified subscriber and with
+ *        the maximum number of subscribers.
+ *
+ * The subscriber does not poll the storage: it is notified as soon as the written record is
+ * stored. The unrelated subscribers do not delay the notification.
+ */
+ZTEST(storage_notifications, test_benchmark_propagation)
+{
+	recorder subscriber;
+	recorder unrelated;
+	non_volatile_storage storage{};
+	zassert_no_error(storage.init());
+
+	zassert_true(storage.subscribe(benchmark_id, subscriber.callback()).has_value());
+	const auto single_cycles = measure_propagation(storage, subscriber);
+
+	// unrelated subscriptions below and above the ID
+	for (uint16_t i = 1U; i < CONFIG_APP_STORAGE_MAX_SUBSCRIPTIONS; ++i) {
+		const auto first = static_cast<uint16_t>((i % 2U == 0U) ? i * 10U : 200U + i * 10U);
+		const auto last = static_cast<uint16_t>(first + 5U);
+		zassert_true(storage.subscribe(first, last, unrelated.callback()).has_value());
+	}
+	const auto all_cycles = measure_propagation(storage, subscriber);
+	zassert_equal(k_sem_count_get(&unrelated.received), 0U);
+
+	uint32_t write_cycles = 0U;
+	for (uint32_t i = 0; i < benchmark_iterations; ++i) {
+		const auto start = k_cycle_get_32();
+		zassert_no_error(storage.write<uint32_t>(benchmark_id + 1U, i));
+		write_cycles += k_cycle_get_32() - start;
+	}
+
+	TC_PRINT("write to notification: %u cycles with 1 subscription, %u cycles with %u "
+		 "subscriptions (write alone %u cycles)\n",
+		 single_cycles, all_cycles, CONFIG_APP_STORAGE_MAX_SUBSCRIPTIONS,
+		 write_cycles / benchmark_iterations);
+}
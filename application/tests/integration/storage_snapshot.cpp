@@ -0,0 +1,288 @@
+#include "assertions.hpp"
+#include "storage/non_volatile_storage.hpp"
+#include <zephyr/ztest.h>
+#include <algorithm>
+
+namespace
+{
+
+constexpr uint16_t first_id = 1U;
+constexpr uint16_t record_count = 5U;
+constexpr uint16_t benchmark_records = 48U;
+constexpr size_t benchmark_record_size = 48U;
+
+/**
+ * @brief Snapshot in RAM, written through a sink and read through a source.
+ */
+struct snapshot_buffer {
+	std::array<uint8_t, 4096> data{};
+	size_t size = 0U;
+
+	storage::snapshot::sink sink()
+	{
+		size = 0U;
+		return [this](std::span<const uint8_t> part) -> util::error_code {
+			if (part.size() > data.size() - size) {
+				return util::errc::no_buffer_space;
+			}
+			std::ranges::copy(part, data.begin() + size);
+			size += part.size();
+			return {};
+		};
+	}
+
+	storage::snapshot::source source()
+	{
+		return [this](size_t offset, std::span<uint8_t> part) -> util::error_code {
+			// a truncated snapshot
+			if (offset > size || part.size() > size - offset) {
+				return storage_error_code::invalid_snapshot;
+			}
+			std::copy_n(data.begin() + offset, part.size(), part.begin());
+			return {};
+		};
+	}
+};
+
+snapshot_buffer snapshot;
+std::array<uint8_t, 64> record_buffer;
+
+/// Data of a record, derived from its ID (and of a length depending on it).
+std::span<const uint8_t> data_of(uint16_t id, std::span<uint8_t> buffer)
+{
+	const auto data = buffer.first(std::min<size_t>(buffer.size(), 4U + id % 8U));
+	for (size_t i = 0; i < data.size(); ++i) {
+		data[i] = static_cast<uint8_t>(id * 7U + i);
+	}
+	return data;
+}
+
+template <storage::backend backend_type>
+void write_records(basic_non_volatile_storage<backend_type> &storage)
+{
+	std::array<uint8_t, 16> buffer;
+	for (uint16_t id = first_id; id < first_id + record_count; ++id) {
+		zassert_no_error(storage.write(id, data_of(id, buffer)));
+	}
+}
+
+template <storage::backend backend_type>
+void check_records(basic_non_volatile_storage<backend_type> &storage)
+{
+	std::array<uint8_t, 16> expected;
+	std::array<uint8_t, 16> buffer;
+	for (uint16_t id = first_id; id < first_id + record_count; ++id) {
+		const auto record = storage.read(id, buffer);
+		zassert_true(record.has_value(), "record %u is missing", id);
+		zassert_true(std::ranges::equal(*record, data_of(id, expected)));
+	}
+}
+
+template <storage::backend backend_type>
+void test_round_trip()
+{
+	basic_non_volatile_storage<backend_type> storage{};
+	zassert_no_error(storage.init());
+	zassert_no_error(storage.clear());
+	zassert_no_error(storage.init());
+
+	write_records(storage);
+	zassert_no_error(storage.export_snapshot(snapshot.sink(), record_buffer));
+	zassert_no_error(storage::snapshot::verify(snapshot.source(), record_buffer));
+
+	// the restore replaces all records, also the ones written after the export
+	zassert_no_error(storage.template write<uint32_t>(100U, 1U));
+	zassert_no_error(storage.write(first_id, std::span<const uint8_t>{}));
+	zassert_no_error(storage.restore_snapshot(snapshot.source(), record_buffer));
+	check_records(storage);
+	zassert_false(storage.template read<uint32_t>(100U).has_value());
+
+	// the restored records are found by the next mount as well
+	zassert_no_error(storage.init());
+	check_records(storage);
+	zassert_no_error(storage.clear());
+}
+
+/**
+ * @brief A restore from a corrupted or truncated snapshot fails before it changes any record.
+ */
+template <storage::backend backend_type>
+void test_failed_restore()
+{
+	basic_non_volatile_storage<backend_type> storage{};
+	zassert_no_error(storage.init());
+	zassert_no_error(storage.clear());
+	zassert_no_error(storage.init());
+
+	write_records(storage);
+	zassert_no_error(storage.export_snapshot(snapshot.sink(), record_buffer));
+	zassert_no_error(storage.template write<uint32_t>(100U, 1U));
+	const util::error_code invalid{storage_error_code::invalid_snapshot};
+
+	// a flipped bit in the data of the last record, only found by the CRC at the end
+	const size_t last_data = snapshot.size - 13U;
+	snapshot.data[last_data] ^= 0x01U;
+	zassert_equal(storage.restore_snapshot(snapshot.source(), record_buffer), invalid);
+	snapshot.data[last_data] ^= 0x01U;
+	check_records(storage);
+	zassert_equal(storage.template read<uint32_t>(100U).value_or(0U), 1U);
+
+	// the CRC at the end is missing
+	snapshot.size -= sizeof(uint32_t);
+	zassert_equal(storage.restore_snapshot(snapshot.source(), record_buffer), invalid);
+	snapshot.size += sizeof(uint32_t);
+	check_records(storage);
+	zassert_equal(storage.template read<uint32_t>(100U).value_or(0U), 1U);
+
+	zassert_no_error(storage.clear());
+}
+
+/**
+ * @brief Cycles of replacing all records by clearing the storage and writing every record, and
+ *        by restoring a snapshot.
+ */
+void benchmark_restore()
+{
+	non_volatile_storage storage{};
+	zassert_no_error(storage.init());
+	zassert_no_error(storage.clear());
+	zassert_no_error(storage.init());
+
+	std::array<uint8_t, benchmark_record_size> data;
+	for (uint16_t id = 0; id < benchmark_records; ++id) {
+		data.fill(static_cast<uint8_t>(id));
+		zassert_no_error(storage.write(id, std::span<const uint8_t>{data}));
+	}
+	zassert_no_error(storage.export_snapshot(snapshot.sink(), record_buffer));
+
+	auto start = k_cycle_get_32();
+	zassert_no_error(storage.clear());
+	zassert_no_error(storage.init());
+	for (uint16_t id = 0; id < benchmark_records; ++id) {
+		data.fill(static_cast<uint8_t>(id));
+		zassert_no_error(storage.write(id, std::span<const uint8_t>{data}));
+	}
+	const uint32_t write_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	zassert_no_error(storage.restore_snapshot(snapshot.source(), record_buffer));
+	const uint32_t restore_cycles = k_cycle_get_32() - start;
+
+	for (uint16_t id = 0; id < benchmark_records; ++id) {
+		const auto record = storage.read(id, data);
+		zassert_true(record.has_value());
+		zassert_true(std::ranges::count(*record, static_cast<uint8_t>(id)) ==
+			     benchmark_record_size);
+	}
+
+	TC_PRINT("%u records of %zu bytes (snapshot of %zu bytes) replaced in %u cycles by writes, "
+		 "in %u cycles by a restore\n",
+		 benchmark_records, benchmark_record_size, snapshot.size, write_cycles,
+		 restore_cycles);
+	zassert_no_error(storage.clear());
+}
+
+} // namespace
+
+ZTEST_SUITE(storage_snapshot, NULL, NULL, NULL, NULL, NULL);
+
+/**
+ * @brief Export and restore with the nvs backend, which restores in a single sequential pass.
+ */
+ZTEST(storage_snapshot, test_nvs_backend)
+{
+	test_round_trip<storage::nvs_backend>();
+}
+
+/**
+ * @brief Export and restore with the RAM backend, which restores with a write per record.
+ */
+ZTEST(storage_snapshot, test_ram_backend)
+{
+	test_round_trip<storage::ram_backend>();
+}
+
+/**
+ * @brief An invalid snapshot leaves the records of the nvs backend as they are.
+ */
+ZTEST(storage_snapshot, test_nvs_backend_failed_restore)
+{
+	test_failed_restore<storage::nvs_backend>();
+}
+
+/**
+ * @brief An invalid snapshot leaves the records of the RAM backend as they are.
+ */
+ZTEST(storage_snapshot, test_ram_backend_failed_restore)
+{
+	test_failed_restore<storage::ram_backend>();
+}
+
+/**
+ * @brief A snapshot of one backend can be restored into another one.
+ */
+ZTEST(storage_snapshot, test_restore_into_other_backend)
+{
+	non_volatile_storage source{};
+	zassert_no_error(source.init());
+	zassert_no_error(source.clear());
+	zassert_no_error(source.init());
+	write_records(source);
+	zassert_no_error(source.export_snapshot(snapshot.sink(), record_buffer));
+	zassert_no_error(source.clear());
+
+	basic_non_volatile_storage<storage::ram_backend> target{};
+	zassert_no_error(target.init());
+	zassert_no_error(target.restore_snapshot(snapshot.source(), record_buffer));
+	check_records(target);
+}
+
+/**
+ * @brief Corrupted, truncated and newer snapshots are rejected.
+ */
+ZTEST(storage_snapshot, test_invalid_snapshots)
+{
+	basic_non_volatile_storage<storage::ram_backend> storage{};
+	zassert_no_error(storage.init());
+	write_records(storage);
+	zassert_no_error(storage.export_snapshot(snapshot.sink(), record_buffer));
+	const util::error_code invalid{storage_error_code::invalid_snapshot};
+
+	// magic
+	snapshot.data[0] ^= 0xffU;
+	zassert_equal(storage::snapshot::verify(snapshot.source(), record_buffer), invalid);
+	snapshot.data[0] ^= 0xffU;
+
+	// version
+	snapshot.data[4] += 1U;
+	zassert_equal(storage::snapshot::verify(snapshot.source(), record_buffer),
+		      util::error_code{storage_error_code::unsupported_snapshot_version});
+	snapshot.data[4] -= 1U;
+
+	// data of the first record (found by the CRC)
+	snapshot.data[12] ^= 0x01U;
+	zassert_equal(storage::snapshot::verify(snapshot.source(), record_buffer), invalid);
+	zassert_equal(storage.restore_snapshot(snapshot.source(), record_buffer), invalid);
+	snapshot.data[12] ^= 0x01U;
+
+	// truncated
+	snapshot.size -= 1U;
+	zassert_equal(storage::snapshot::verify(snapshot.source(), record_buffer), invalid);
+	snapshot.size += 1U;
+
+	// records larger than the buffer
+	const auto too_small =
+		storage::snapshot::verify(snapshot.source(), std::span{record_buffer}.first(4U));
+	zassert_true(too_small == util::error_condition{util::errc::no_buffer_space});
+
+	zassert_no_error(storage::snapshot::verify(snapshot.source(), record_buffer));
+}
+
+/**
+ * @brief A restore writes the records sequentially into the erased sectors, instead of
+ *        searching the allocation table for the previous data of every record.
+ */
+ZTEST(storage_snapshot, test_benchmark_restore)
+{
+	benchmark_restore();
+}
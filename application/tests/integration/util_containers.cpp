@@ -0,0 +1,115 @@
+#include "util/inplace_function.hpp"
+#include "util/small_map.hpp"
+#include "util/static_vector.hpp"
+#include <zephyr/ztest.h>
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace
+{
+
+constexpr uint32_t iterations = 100U;
+constexpr size_t element_count = 16U;
+
+/// Callback context that exceeds the small buffer of std::function, as it is common for callbacks
+/// that capture a few references.
+struct callback_context {
+	uint32_t *counter;
+	uint32_t increment;
+	std::array<uint32_t, 2> padding;
+};
+
+using inplace_callback = util::inplace_function<void(), sizeof(callback_context)>;
+
+/**
+ * @brief Average cycles of the function over the iterations.
+ */
+template <typename function_type>
+uint32_t measure(function_type &&function)
+{
+	const auto start = k_cycle_get_32();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		function();
+	}
+	return (k_cycle_get_32() - start) / iterations;
+}
+
+} // namespace
+
+ZTEST_SUITE(util_containers, NULL, NULL, NULL, NULL, NULL);
+
+/**
+ * @brief Cycles of creating and calling a callback: std::function compared to inplace_function.
+ */
+ZTEST(util_containers, test_benchmark_callbacks)
+{
+	uint32_t counter = 0U;
+	const callback_context context{&counter, 1U, {}};
+
+	const auto std_cycles = measure([&context] {
+		const std::function<void()> callback = [context] {
+			*context.counter += context.increment;
+		};
+		callback();
+	});
+	const auto inplace_cycles = measure([&context] {
+		const inplace_callback callback = [context] {
+			*context.counter += context.increment;
+		};
+		callback();
+	});
+	zassert_equal(counter, 2U * iterations);
+
+	// the call alone, with the callbacks created beforehand
+	const std::function<void()> std_callback = [context] { *context.counter += 1U; };
+	const inplace_callback callback = [context] { *context.counter += 1U; };
+	const auto std_call_cycles = measure([&std_callback] { std_callback(); });
+	const auto inplace_call_cycles = measure([&callback] { callback(); });
+
+	TC_PRINT("callback of %zu bytes, create and call: std::function %u cycles, "
+		 "util::inplace_function %u cycles\n",
+		 sizeof(callback_context), std_cycles, inplace_cycles);
+	TC_PRINT("callback call: std::function %u cycles, util::inplace_function %u cycles\n",
+		 std_call_cycles, inplace_call_cycles);
+}
+
+/**
+ * @brief Cycles of filling a vector and of ID lookups: the std containers compared to util.
+ */
+ZTEST(util_containers, test_benchmark_containers)
+{
+	uint32_t sum = 0U;
+
+	const auto std_vector_cycles = measure([&sum] {
+		std::vector<uint32_t> values;
+		for (uint32_t i = 0; i < element_count; ++i) {
+			values.push_back(i);
+		}
+		sum += values.back();
+	});
+	const auto static_vector_cycles = measure([&sum] {
+		util::static_vector<uint32_t, element_count> values;
+		for (uint32_t i = 0; i < element_count; ++i) {
+			values.push_back(i);
+		}
+		sum += values.back();
+	});
+	zassert_equal(sum, 2U * iterations * (element_count - 1U));
+
+	util::small_map<uint16_t, uint32_t, element_count> map;
+	for (uint16_t id = 0; id < element_count; ++id) {
+		map.insert_or_assign(static_cast<uint16_t>(id * 3U), id);
+	}
+	uint32_t found = 0U;
+	const auto lookup_cycles = measure([&map, &found] {
+		for (uint16_t id = 0; id < element_count; ++id) {
+			found += (map.get(static_cast<uint16_t>(id * 3U)) != nullptr) ? 1U : 0U;
+		}
+	});
+	zassert_equal(found, iterations * element_count);
+
+	TC_PRINT("filling %zu elements: std::vector %u cycles, util::static_vector %u cycles\n",
+		 element_count, std_vector_cycles, static_vector_cycles);
+	TC_PRINT("%zu lookups in util::small_map: %u cycles\n", element_count, lookup_cycles);
+}
@@ -0,0 +1,260 @@
+#include "assertions.hpp"
+#include "storage/non_volatile_storage.hpp"
+#include <zephyr/ztest.h>
+
+namespace
+{
+
+constexpr uint16_t pathological_id = 10U;
+constexpr uint16_t normal_id = 20U;
+constexpr uint16_t normal_ids = 4U;
+constexpr uint32_t benchmark_iterations = 20U;
+
+/// Wait until the deferred writes were written in the next interval.
+constexpr int32_t interval_ms = CONFIG_APP_STORAGE_WEAR_INTERVAL * 1000 + 500;
+
+void clear_storage()
+{
+	non_volatile_storage storage{};
+	zassert_no_error(storage.init());
+	zassert_no_error(storage.clear());
+}
+
+/**
+ * @brief Average cycles of writing the normal keys (optionally alternated with writes of the
+ *        pathological writer).
+ *
+ * The normal keys are written within their budgets of one interval.
+ */
+uint32_t measure_normal_writes(non_volatile_storage &storage, bool with_pathological_writer)
+{
+	// starts with the budgets of a new interval
+	k_msleep(interval_ms);
+
+	uint32_t total_cycles = 0U;
+	for (uint32_t i = 0; i < benchmark_iterations; ++i) {
+		if (with_pathological_writer) {
+			for (uint32_t j = 0; j < 10U; ++j) {
+				const uint32_t value = i * 10U + j;
+				zassert_no_error(storage.write<uint32_t>(pathological_id, value));
+			}
+		}
+
+		const auto start = k_cycle_get_32();
+		zassert_no_error(storage.write<uint32_t>(normal_id + (i % normal_ids), i));
+		total_cycles += k_cycle_get_32() - start;
+	}
+	return total_cycles / benchmark_iterations;
+}
+
+} // namespace
+
+ZTEST_SUITE(wear_governor, NULL, NULL, NULL, NULL, NULL);
+
+/**
+ * @brief A writer in a loop is coalesced to a single write per interval, while its latest value
+ *        can still be read.
+ */
+ZTEST(wear_governor, test_pathological_writer)
+{
+	clear_storage();
+	non_volatile_storage storage{};
+	zassert_no_error(storage.init());
+
+	const auto before = storage.wear().statistics();
+	for (uint32_t i = 0; i < 1000U; ++i) {
+		zassert_no_error(storage.write<uint32_t>(pathological_id, i));
+		zassert_equal(storage.read<uint32_t>(pathological_id).value_or(0U), i);
+	}
+
+	const auto after = storage.wear().statistics();
+	const auto programmed = after.bytes_programmed - before.bytes_programmed;
+	zassert_true(programmed <= CONFIG_APP_STORAGE_WEAR_ID_BUDGET);
+	zassert_equal(after.deferred_writes - before.deferred_writes, 1U);
+	zassert_true(after.coalesced_writes - before.coalesced_writes > 900U);
+	zassert_equal(after.forced_writes, before.forced_writes);
+	zassert_equal(storage.wear().pending(), 1U);
+
+	// the deferred value is written in the next interval
+	k_msleep(interval_ms);
+	zassert_equal(storage.wear().pending(), 0U);
+	{
+		// the latest value is stored in the flash
+		non_volatile_storage reader{};
+		zassert_no_error(reader.init());
+		zassert_equal(reader.read<uint32_t>(pathological_id).value_or(0U), 999U);
+	}
+
+	TC_PRINT("1000 writes programmed %llu bytes, deferred %u, coalesced %u\n",
+		 static_cast<unsigned long long>(programmed),
+		 after.deferred_writes - before.deferred_writes,
+		 after.coalesced_writes - before.coalesced_writes);
+}
+
+/**
+ * @brief Deferred deletes, flushing and clearing.
+ */
+ZTEST(wear_governor, test_deferred_operations)
+{
+	clear_storage();
+	non_volatile_storage storage{};
+	zassert_no_error(storage.init());
+
+	// with changing values, as writes of the stored data are not accounted
+	for (uint32_t value = 0U; storage.wear().pending() == 0U; ++value) {
+		zassert_no_error(storage.write<uint32_t>(pathological_id, value));
+	}
+
+	// a deferred delete makes the record unreadable
+	zassert_no_error(storage.write(pathological_id, std::span<const uint8_t>{}));
+	zassert_false(storage.read<uint32_t>(pathological_id).has_value());
+	zassert_no_error(storage.write<uint32_t>(pathological_id, 2U));
+
+	// views get a copy of the deferred data
+	std::array<uint8_t, sizeof(uint32_t)> fallback_buffer{};
+	{
+		const auto record = storage.view(pathological_id, fallback_buffer);
+		zassert_true(record.has_value());
+		zassert_equal(record->data().size(), sizeof(uint32_t));
+		zassert_false(record->is_zero_copy());
+	}
+
+	// without a buffer, the view does not write the deferred data over its budget
+	const auto unbuffered = storage.view(pathological_id);
+	zassert_false(unbuffered.has_value());
+	zassert_true(unbuffered.error() == storage_error_code::wrong_data_size);
+	zassert_equal(storage.wear().pending(), 1U);
+
+	zassert_no_error(storage.flush());
+	zassert_equal(storage.wear().pending(), 0U);
+	zassert_equal(storage.read<uint32_t>(pathological_id).value_or(0U), 2U);
+
+	// clearing drops the deferred writes
+	for (uint32_t value = 3U; storage.wear().pending() == 0U; ++value) {
+		zassert_no_error(storage.write<uint32_t>(pathological_id, value));
+	}
+	zassert_no_error(storage.clear());
+	zassert_no_error(storage.init());
+	zassert_equal(storage.wear().pending(), 0U);
+	zassert_false(storage.read<uint32_t>(pathological_id).has_value());
+}
+
+/**
+ * @brief Writes of the stored data are neither accounted nor deferred, as the backends do not
+ *        program them.
+ */
+ZTEST(wear_governor, test_unchanged_writes)
+{
+	clear_storage();
+	non_volatile_storage storage{};
+	zassert_no_error(storage.init());
+	zassert_no_error(storage.write<uint32_t>(normal_id, 7U));
+
+	// the accounting is persisted in the next interval and not again without new writes
+	k_msleep(interval_ms);
+	const auto before = storage.wear().statistics();
+	for (uint32_t i = 0; i < 100U; ++i) {
+		zassert_no_error(storage.write<uint32_t>(normal_id, 7U));
+	}
+
+	const auto after = storage.wear().statistics();
+	zassert_equal(after.bytes_programmed, before.bytes_programmed);
+	zassert_equal(after.unchanged_writes - before.unchanged_writes, 100U);
+	zassert_equal(after.deferred_writes, before.deferred_writes);
+	zassert_equal(storage.wear().pending(), 0U);
+}
+
+/**
+ * @brief Writes over the global budget are deferred as well and writes that can not be deferred
+ *        are forced, instead of failing.
+ */
+ZTEST(wear_governor, test_global_budget)
+{
+	clear_storage();
+	non_volatile_storage storage{};
+	zassert_no_error(storage.init());
+
+	// every ID is written once, which is within its own budget
+	std::array<uint8_t, 32> data{};
+	constexpr size_t ids = CONFIG_APP_STORAGE_WEAR_GLOBAL_BUDGET / data.size() + 8U;
+	for (uint16_t id = 100U; id < 100U + ids; ++id) {
+		data.fill(static_cast<uint8_t>(id));
+		zassert_no_error(storage.write(id, std::span<const uint8_t>{data}));
+	}
+
+	const auto statistics = storage.wear().statistics();
+	zassert_equal(statistics.deferred_writes, CONFIG_APP_STORAGE_WEAR_MAX_DEFERRED);
+	zassert_true(statistics.forced_writes > 0U);
+
+	// all records are readable and get written in the following intervals
+	for (uint16_t id = 100U; id < 100U + ids; ++id) {
+		const auto record = storage.read(id, data);
+		zassert_true(record.has_value());
+		zassert_equal(record->front(), static_cast<uint8_t>(id));
+	}
+	k_msleep(interval_ms);
+	zassert_equal(storage.wear().pending(), 0U);
+}
+
+/**
+ * @brief The accounting is persisted and restored by the next instance, which projects the
+ *        lifetime of the flash from it.
+ */
+ZTEST(wear_governor, test_persisted_accounting)
+{
+	clear_storage();
+	uint64_t programmed = 0U;
+	{
+		non_volatile_storage storage{};
+		zassert_no_error(storage.init());
+		for (uint32_t i = 0; i < 10U; ++i) {
+			zassert_no_error(storage.write<uint32_t>(normal_id + i, i));
+		}
+		k_msleep(interval_ms);
+
+		const auto persisted = storage.read<std::array<uint64_t, 2>>(
+			CONFIG_APP_STORAGE_WEAR_RECORD_ID);
+		zassert_true(persisted.has_value());
+		programmed = (*persisted)[0];
+		zassert_true(programmed > 0U);
+
+		const auto lifetime = storage.wear().projected_lifetime();
+		zassert_true(lifetime.has_value());
+		TC_PRINT("projected lifetime at this rate: %lld hours\n",
+			 static_cast<long long>(lifetime->count()));
+	}
+
+	non_volatile_storage storage{};
+	zassert_no_error(storage.init());
+	k_msleep(interval_ms);
+	zassert_true(storage.wear().statistics().bytes_programmed >= programmed);
+}
+
+/**
+ * @brief Cycles of writing normal keys, alone and while a pathological writer writes a key in a
+ *        loop.
+ *
+ * The normal keys stay within their budgets and are written directly, while the writes of the
+ * pathological writer are coalesced in RAM. So the latency of the normal keys does not suffer
+ * from the pathological writer, which would otherwise fill the sectors and trigger their garbage
+ * collection.
+ */
+ZTEST(wear_governor, test_benchmark_latency)
+{
+	clear_storage();
+	non_volatile_storage storage{};
+	zassert_no_error(storage.init());
+
+	const auto alone_cycles = measure_normal_writes(storage, false);
+	const auto before = storage.wear().statistics();
+	const auto contended_cycles = measure_normal_writes(storage, true);
+	const auto after = storage.wear().statistics();
+
+	// only the writes of the pathological writer were deferred
+	zassert_equal(after.forced_writes, before.forced_writes);
+	zassert_equal(after.deferred_writes - before.deferred_writes, 1U);
+	TC_PRINT("normal write: %u cycles alone, %u cycles with a pathological writer "
+		 "(%u of its writes deferred, %u coalesced)\n",
+		 alone_cycles, contended_cycles, after.deferred_writes - before.deferred_writes,
+		 after.coalesced_writes - before.coalesced_writes);
+}
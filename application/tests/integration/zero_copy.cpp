@@ -0,0 +1,84 @@
+#include "assertions.hpp"
+#include "storage/non_volatile_storage.hpp"
+#include <zephyr/ztest.h>
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+
+constexpr uint16_t table_id = 7U;
+constexpr std::array<uint8_t, 5> table{1U, 2U, 3U, 4U, 5U};
+
+K_THREAD_STACK_DEFINE(writer_stack, 2048);
+struct k_thread writer_thread;
+std::atomic<bool> write_done{false};
+
+template <storage::backend backend_type>
+void writer(void *storage, void *, void *)
+{
+	auto &nvs = *static_cast<basic_non_volatile_storage<backend_type> *>(storage);
+	zassert_no_error(nvs.template write<uint32_t>(table_id + 1U, 42U));
+	write_done = true;
+}
+
+/**
+ * @brief Checks that a view gives the stored data and that it blocks writes while it exists.
+ */
+template <storage::backend backend_type>
+void test_view()
+{
+	basic_non_volatile_storage<backend_type> storage{};
+	zassert_no_error(storage.init());
+	zassert_no_error(storage.clear());
+	zassert_no_error(storage.init());
+	zassert_no_error(storage.write(table_id, std::span<const uint8_t>{table}));
+
+	std::array<uint8_t, table.size()> fallback_buffer{};
+	{
+		const auto record = storage.view(table_id, fallback_buffer);
+		zassert_true(record.has_value());
+		zassert_true(std::ranges::equal(record->data(), table));
+		zassert_equal(record->is_zero_copy(), storage::mappable_backend<backend_type>);
+		if (record->is_zero_copy()) {
+			zassert_not_equal(record->data().data(), fallback_buffer.data());
+		}
+
+		// a concurrent write must wait until the record is not pinned anymore
+		write_done = false;
+		k_thread_create(&writer_thread, writer_stack, K_THREAD_STACK_SIZEOF(writer_stack),
+				writer<backend_type>, &storage, nullptr, nullptr,
+				K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+		k_msleep(10);
+		zassert_equal(write_done.load(), !record->is_zero_copy());
+	}
+
+	k_thread_join(&writer_thread, K_FOREVER);
+	zassert_true(write_done.load());
+
+	// views of missing records fail
+	const auto missing = storage.view(table_id + 2U, fallback_buffer);
+	zassert_false(missing.has_value());
+
+	zassert_no_error(storage.clear());
+}
+
+} // namespace
+
+ZTEST_SUITE(zero_copy, NULL, NULL, NULL, NULL, NULL);
+
+/**
+ * @brief Test zero-copy read access with the RAM backend.
+ */
+ZTEST(zero_copy, test_ram_backend_view)
+{
+	test_view<storage::ram_backend>();
+}
+
+/**
+ * @brief Test zero-copy read access with the nvs backend on the memory-mapped flash simulator.
+ */
+ZTEST(zero_copy, test_nvs_backend_view)
+{
+	test_view<storage::nvs_backend>();
+}
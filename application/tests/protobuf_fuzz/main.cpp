@@ -0,0 +1,429 @@
+#include <zephyr/ztest.h>
+#include "protobuf/fuzz.pb.h"
+#include "protobuf/protobuf_message.hpp"
+#include "protobuf/storage_messages.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <span>
+#include <vector>
+
+PROTOBUF_SCALAR_CODEC(ExtendedStatistics);
+PROTOBUF_NANOPB_CODEC(StatisticsLog);
+
+static_assert(protobuf::codec<RuntimeStatistics>::available);
+static_assert(protobuf::codec<ExtendedStatistics>::available);
+
+namespace
+{
+
+constexpr uint32_t iterations = PROTOBUF_FUZZ_ITERATIONS;
+
+/// Generated messages that the measurements and the mutations cycle through.
+constexpr size_t pool_size = 256U;
+/// Bytes that a mutation can insert into an encoded message.
+constexpr size_t mutation_space = 16U;
+
+/**
+ * @brief Deterministic pseudo-random numbers (xorshift64*), so that every run with the same seed
+ *        (see PROTOBUF_FUZZ_SEED) generates and mutates the same messages.
+ */
+class random_source
+{
+public:
+	explicit random_source(uint64_t seed) : state{(seed != 0U) ? seed : 1U}
+	{
+	}
+
+	uint64_t next()
+	{
+		state ^= state >> 12;
+		state ^= state << 25;
+		state ^= state >> 27;
+		return state * 2685821657736338717ULL;
+	}
+
+	uint64_t below(uint64_t bound)
+	{
+		return next() % bound;
+	}
+
+	/**
+	 * @brief Values biased towards the edge cases of the wire format: zero (omitted), one byte
+	 *        varints and the limits of the type.
+	 */
+	template <typename type>
+	type value()
+	{
+		if constexpr (std::is_same_v<type, bool>) {
+			return below(2U) != 0U;
+		} else if constexpr (std::is_floating_point_v<type>) {
+			using bits = std::conditional_t<sizeof(type) == 4U, uint32_t, uint64_t>;
+			if (below(4U) == 0U) {
+				return type{};
+			}
+			return std::bit_cast<type>(static_cast<bits>(next()));
+		} else {
+			switch (below(5U)) {
+			case 0:
+				return type{};
+			case 1:
+				return static_cast<type>(below(128U));
+			case 2:
+				return std::numeric_limits<type>::max();
+			case 3:
+				return std::numeric_limits<type>::min();
+			default:
+				return static_cast<type>(next());
+			}
+		}
+	}
+
+private:
+	uint64_t state;
+};
+
+uint64_t seed()
+{
+	const char *value = std::getenv("PROTOBUF_FUZZ_SEED");
+	return (value != nullptr) ? std::strtoull(value, nullptr, 0) : 0x5eed5eedU;
+}
+
+void generate(random_source &random, RuntimeStatistics &message)
+{
+	message = RuntimeStatistics_init_default;
+	message.boot_count = random.value<uint32_t>();
+}
+
+void generate(random_source &random, ExtendedStatistics &message)
+{
+	message = ExtendedStatistics_init_default;
+	message.boot_count = random.value<uint32_t>();
+	message.uptime_seconds = random.value<uint64_t>();
+	message.reset_reason = static_cast<ResetReason>(random.below(4U));
+	message.min_temperature = random.value<int32_t>();
+	message.max_temperature = random.value<int32_t>();
+	message.supply_voltage = random.value<float>();
+	message.flash_erase_count = random.value<uint32_t>();
+	message.crashed = random.value<bool>();
+	message.clock_drift_ns = random.value<int64_t>();
+	message.average_load = random.value<double>();
+}
+
+void generate(random_source &random, StatisticsLog &message)
+{
+	message = StatisticsLog_init_default;
+
+	const auto length = random.below(sizeof(message.firmware_version));
+	for (size_t i = 0; i < length; ++i) {
+		message.firmware_version[i] = static_cast<char>('a' + random.below(26U));
+	}
+
+	message.boots_count = static_cast<pb_size_t>(random.below(std::size(message.boots) + 1U));
+	for (pb_size_t i = 0; i < message.boots_count; ++i) {
+		generate(random, message.boots[i]);
+	}
+
+	message.crash_dump.size =
+		static_cast<pb_size_t>(random.below(sizeof(message.crash_dump.bytes) + 1U));
+	for (size_t i = 0; i < message.crash_dump.size; ++i) {
+		message.crash_dump.bytes[i] = static_cast<pb_byte_t>(random.next());
+	}
+}
+
+/**
+ * @brief Applies one to four mutations to an encoded message: flipped bits, random bytes, bytes
+ *        that are special in the wire format, inserted and removed bytes and truncations.
+ *
+ * @return The length of the mutated message in the buffer.
+ */
+size_t mutate(random_source &random, std::span<uint8_t> buffer, size_t length)
+{
+	// continuation bit of varints, maximum length of a field and all wire types
+	constexpr std::array<uint8_t, 8> special{0x00U, 0x01U, 0x02U, 0x05U,
+						 0x7FU, 0x80U, 0xFEU, 0xFFU};
+
+	const auto mutations = 1U + random.below(4U);
+	for (uint64_t i = 0; i < mutations; ++i) {
+		const auto position = random.below(length + 1U);
+		switch (random.below(6U)) {
+		case 0:
+			if (position < length) {
+				buffer[position] ^= static_cast<uint8_t>(1U << random.below(8U));
+			}
+			break;
+		case 1:
+			if (position < length) {
+				buffer[position] = static_cast<uint8_t>(random.next());
+			}
+			break;
+		case 2:
+			if (position < length) {
+				buffer[position] = special[random.below(special.size())];
+			}
+			break;
+		case 3:
+			if (length < buffer.size()) {
+				const auto end = buffer.begin() + length;
+				std::copy_backward(buffer.begin() + position, end, end + 1);
+				buffer[position] = static_cast<uint8_t>(random.next());
+				++length;
+			}
+			break;
+		case 4:
+			if (position < length) {
+				std::copy(buffer.begin() + position + 1, buffer.begin() + length,
+					  buffer.begin() + position);
+				--length;
+			}
+			break;
+		default:
+			length = position;
+			break;
+		}
+	}
+	return length;
+}
+
+/**
+ * @brief Keeps the compiler from optimizing away a measured encoding or decoding.
+ */
+template <typename type>
+void keep(const type &value)
+{
+	asm volatile("" : : "g"(&value) : "memory");
+}
+
+template <typename function_type>
+uint64_t messages_per_second(function_type &&function)
+{
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		function(i);
+	}
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	return (elapsed.count() > 0.0) ? static_cast<uint64_t>(iterations / elapsed.count()) : 0U;
+}
+
+void print_hex(std::span<const uint8_t> data)
+{
+	for (const auto byte : data) {
+		TC_PRINT("%02x", byte);
+	}
+	TC_PRINT("\n");
+}
+
+/**
+ * @brief Encoded messages of a pool of generated messages.
+ */
+template <size_t maximum_size>
+struct encoded_pool {
+	std::vector<std::array<uint8_t, maximum_size>> data;
+	std::vector<size_t> sizes;
+
+	std::span<const uint8_t> operator[](size_t index) const
+	{
+		return std::span{data[index]}.first(sizes[index]);
+	}
+};
+
+/**
+ * @brief Measures the encoding and decoding of generated messages with protobuf::message and
+ *        checks that every one of them decodes to the same message.
+ */
+template <typename message_type, size_t maximum_size>
+encoded_pool<maximum_size> measure(const char *name, const pb_msgdesc_t &descriptor,
+				   random_source &random)
+{
+	using message = protobuf::message<message_type, maximum_size>;
+
+	std::vector<message> messages(pool_size, message{descriptor});
+	encoded_pool<maximum_size> pool{std::vector<std::array<uint8_t, maximum_size>>(pool_size),
+					std::vector<size_t>(pool_size)};
+	for (size_t i = 0; i < pool_size; ++i) {
+		generate(random, messages[i].data());
+		const auto encoded = messages[i].encode(pool.data[i]);
+		zassert_true(encoded.has_value(), "%s %zu not encoded", name, i);
+		pool.sizes[i] = encoded->size();
+	}
+
+	std::array<uint8_t, maximum_size> buffer;
+	const auto encode_rate = messages_per_second([&](uint32_t i) {
+		const auto encoded = messages[i % pool_size].encode(buffer);
+		keep(encoded);
+	});
+
+	message decoded{descriptor};
+	const auto decode_rate = messages_per_second([&](uint32_t i) {
+		const auto error = decoded.decode(pool[i % pool_size]);
+		keep(error);
+		keep(decoded.data());
+	});
+
+	for (size_t i = 0; i < pool_size; ++i) {
+		zassert_false(decoded.decode(pool[i]), "%s %zu not decoded", name, i);
+		const auto encoded = decoded.encode(buffer);
+		zassert_true(encoded.has_value() && std::ranges::equal(*encoded, pool[i]),
+			     "%s %zu decoded to another message", name, i);
+	}
+
+	TC_PRINT("%s: encode %llu msg/s, decode %llu msg/s (protobuf::message)\n", name,
+		 static_cast<unsigned long long>(encode_rate),
+		 static_cast<unsigned long long>(decode_rate));
+	return pool;
+}
+
+/**
+ * @brief Measures the encoding and decoding with nanopb directly, for comparing it with the
+ *        scalar codec.
+ */
+template <typename message_type, size_t maximum_size>
+void measure_nanopb(const char *name, const pb_msgdesc_t &descriptor,
+		    const encoded_pool<maximum_size> &pool)
+{
+	std::vector<message_type> messages(pool_size);
+	for (size_t i = 0; i < pool_size; ++i) {
+		zassert_false(protobuf::detail::decode(descriptor, &messages[i], pool[i]));
+	}
+
+	std::array<uint8_t, maximum_size> buffer;
+	const auto encode_rate = messages_per_second([&](uint32_t i) {
+		const auto encoded =
+			protobuf::detail::encode(descriptor, &messages[i % pool_size], buffer);
+		keep(encoded);
+	});
+
+	message_type decoded;
+	const auto decode_rate = messages_per_second([&](uint32_t i) {
+		const auto encoded = pool[i % pool_size];
+		const auto error = protobuf::detail::decode(descriptor, &decoded, encoded);
+		keep(error);
+		keep(decoded);
+	});
+
+	TC_PRINT("%s: encode %llu msg/s, decode %llu msg/s (nanopb)\n", name,
+		 static_cast<unsigned long long>(encode_rate),
+		 static_cast<unsigned long long>(decode_rate));
+}
+
+/**
+ * @brief Decodes mutated messages with protobuf::message.
+ *
+ * A crash of the decoder ends the test binary. Every accepted input has to decode to a message
+ * that encodes to a canonical form, which decodes and encodes to the same bytes again. For the
+ * messages with the scalar codec, every input has to be accepted or rejected like by nanopb and
+ * the accepted ones have to decode to the same message. The differing inputs are counted and the
+ * first of them is printed.
+ */
+template <typename message_type, size_t maximum_size>
+void fuzz(const char *name, const pb_msgdesc_t &descriptor, const encoded_pool<maximum_size> &pool,
+	  random_source &random)
+{
+	using message = protobuf::message<message_type, maximum_size>;
+	constexpr bool has_codec = protobuf::codec<message_type>::available;
+
+	message decoded{descriptor};
+	message redecoded{descriptor};
+	std::array<uint8_t, maximum_size + mutation_space> input;
+	std::array<uint8_t, maximum_size> canonical;
+	std::array<uint8_t, maximum_size> reencoded;
+
+	uint32_t accepted = 0U;
+	uint32_t mismatches = 0U;
+	std::vector<uint8_t> first_mismatch;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		const auto original = pool[random.below(pool_size)];
+		std::ranges::copy(original, input.begin());
+		const auto length = mutate(random, input, original.size());
+		const auto mutated = std::span<const uint8_t>{input}.first(length);
+
+		const bool is_accepted = !decoded.decode(mutated);
+		if (is_accepted) {
+			++accepted;
+			const auto first = decoded.encode(canonical);
+			zassert_true(first.has_value(), "%s: input %u not encoded again", name, i);
+			zassert_false(redecoded.decode(*first), "%s: input %u not decoded again",
+				      name, i);
+			const auto second = redecoded.encode(reencoded);
+			zassert_true(second.has_value() && std::ranges::equal(*first, *second),
+				     "%s: input %u has no canonical encoding", name, i);
+		}
+
+		if constexpr (has_codec) {
+			message_type by_nanopb;
+			const bool nanopb_accepted =
+				!protobuf::detail::decode(descriptor, &by_nanopb, mutated);
+
+			message_type by_codec;
+			const bool codec_accepted =
+				!protobuf::codec<message_type>::decode(mutated, by_codec);
+			bool same = (codec_accepted == nanopb_accepted);
+			if (same && nanopb_accepted) {
+				const auto nanopb_encoded =
+					protobuf::detail::encode(descriptor, &by_nanopb, canonical);
+				const auto codec_encoded =
+					protobuf::detail::encode(descriptor, &by_codec, reencoded);
+				same = nanopb_encoded && codec_encoded &&
+				       std::ranges::equal(*nanopb_encoded, *codec_encoded);
+			}
+			if (!same && (mismatches++ == 0U)) {
+				first_mismatch.assign(mutated.begin(), mutated.end());
+			}
+		}
+	}
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	TC_PRINT("%s: %u mutated messages decoded in %.2f s, %u accepted\n", name, iterations,
+		 elapsed.count(), accepted);
+	if (mismatches > 0U) {
+		TC_PRINT("%s: %u decoded differently by nanopb and the scalar codec, e.g. ", name,
+			 mismatches);
+		print_hex(first_mismatch);
+	}
+	zassert_equal(mismatches, 0U, "%s: the scalar codec differs from nanopb", name);
+}
+
+template <typename message_type, size_t maximum_size>
+void run(const char *name, const pb_msgdesc_t &descriptor)
+{
+	random_source random{seed()};
+	const auto pool = measure<message_type, maximum_size>(name, descriptor, random);
+	if constexpr (protobuf::codec<message_type>::available) {
+		measure_nanopb<message_type>(name, descriptor, pool);
+	}
+	fuzz<message_type>(name, descriptor, pool, random);
+}
+
+} // namespace
+
+ZTEST_SUITE(protobuf_fuzz, NULL, NULL, NULL, NULL, NULL);
+
+/**
+ * @brief The message of storage.proto, with the scalar codec.
+ */
+ZTEST(protobuf_fuzz, test_runtime_statistics)
+{
+	run<RuntimeStatistics, RuntimeStatistics_size>("RuntimeStatistics", RuntimeStatistics_msg);
+}
+
+/**
+ * @brief A message with every kind of scalar field, with the scalar codec.
+ */
+ZTEST(protobuf_fuzz, test_extended_statistics)
+{
+	run<ExtendedStatistics, ExtendedStatistics_size>("ExtendedStatistics",
+							 ExtendedStatistics_msg);
+}
+
+/**
+ * @brief A message with a string, bytes and repeated sub-messages, decoded by nanopb.
+ */
+ZTEST(protobuf_fuzz, test_statistics_log)
+{
+	run<StatisticsLog, StatisticsLog_size>("StatisticsLog", StatisticsLog_msg);
+}
@@ -0,0 +1,206 @@
+#include "assertions.hpp"
+#include <zephyr/settings/settings.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/ztest.h>
+#ifdef CONFIG_APP_SETTINGS_BACKEND
+#include "storage/settings_backend.hpp"
+#endif
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+
+namespace
+{
+
+constexpr uint32_t setting_count = 300U;
+constexpr uint32_t single_setting = 150U;
+
+#ifdef CONFIG_APP_SETTINGS_BACKEND
+constexpr const char *backend_name = "non_volatile_storage with index";
+#else
+constexpr const char *backend_name = "nvs of Zephyr";
+#endif
+
+/// Loaded values of the settings "bench/<index>".
+std::array<uint32_t, setting_count> values;
+uint32_t loaded_count;
+
+uint32_t value_of(uint32_t index)
+{
+	return index * 2654435761U;
+}
+
+int set_bench(const char *key, size_t length, settings_read_cb read_cb, void *argument)
+{
+	const auto index = strtoul(key, nullptr, 10);
+	uint32_t value;
+	if (index >= setting_count || length != sizeof(value)) {
+		return -EINVAL;
+	}
+	if (read_cb(argument, &value, sizeof(value)) != sizeof(value)) {
+		return -EIO;
+	}
+
+	values[index] = value;
+	++loaded_count;
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(bench, "bench", nullptr, set_bench, nullptr, nullptr);
+
+/**
+ * @brief Reads the value of a single setting, given to settings_load_subtree_direct().
+ */
+int read_single(const char *key, size_t length, settings_read_cb read_cb, void *argument,
+		void *param)
+{
+	// only the setting itself (without a key relative to it), not the ones below it
+	if (key != nullptr) {
+		return 0;
+	}
+
+	auto &value = *static_cast<std::optional<uint32_t> *>(param);
+	uint32_t data;
+	if (length == sizeof(data) && read_cb(argument, &data, sizeof(data)) == sizeof(data)) {
+		value = data;
+	}
+	return 0;
+}
+
+struct name {
+	std::array<char, 16> text;
+
+	explicit name(uint32_t index)
+	{
+		(void)snprintf(text.data(), text.size(), "bench/%u", index);
+	}
+
+	operator const char *() const
+	{
+		return text.data();
+	}
+};
+
+std::optional<uint32_t> load_single(uint32_t index)
+{
+	std::optional<uint32_t> value;
+	zassert_ok(settings_load_subtree_direct(name{index}, read_single, &value));
+	return value;
+}
+
+uint32_t load_all()
+{
+	values.fill(0U);
+	loaded_count = 0U;
+	zassert_ok(settings_load_subtree("bench"));
+	return loaded_count;
+}
+
+void *setup(void)
+{
+	// both backends start from an erased partition
+	const struct flash_area *area;
+	zassert_ok(flash_area_open(FIXED_PARTITION_ID(storage_partition), &area));
+	zassert_ok(flash_area_erase(area, 0, area->fa_size));
+	flash_area_close(area);
+
+#ifdef CONFIG_APP_SETTINGS_BACKEND
+	// the backend stores the settings through the storage of the application
+	zassert_no_error(shared_storage().init());
+#endif
+	zassert_ok(settings_subsys_init());
+
+	const auto start = k_cycle_get_32();
+	for (uint32_t i = 0; i < setting_count; ++i) {
+		const uint32_t value = value_of(i);
+		zassert_ok(settings_save_one(name{i}, &value, sizeof(value)));
+	}
+	TC_PRINT("%s: %u settings saved in %u us\n", backend_name, setting_count,
+		 k_cyc_to_us_floor32(k_cycle_get_32() - start));
+	return nullptr;
+}
+
+} // namespace
+
+ZTEST_SUITE(settings, NULL, setup, NULL, NULL, NULL);
+
+/**
+ * @brief Loads the subtree of all settings and a single setting, which the stock backend does by
+ *        reading all names on the flash and the indexed backend by reading the matching records.
+ *
+ * The load times of both backends are compared by running the scenarios of testcase.yaml.
+ */
+ZTEST(settings, test_benchmark_load)
+{
+	auto start = k_cycle_get_32();
+	const auto count = load_all();
+	const uint32_t subtree_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	zassert_equal(count, setting_count);
+	for (uint32_t i = 0; i < setting_count; ++i) {
+		zassert_equal(values[i], value_of(i), "setting %u", i);
+	}
+
+	start = k_cycle_get_32();
+	const auto single = load_single(single_setting);
+	const uint32_t single_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	zassert_true(single.has_value());
+	zassert_equal(*single, value_of(single_setting));
+
+	TC_PRINT("%s: subtree of %u settings loaded in %u us, a single setting in %u us\n",
+		 backend_name, setting_count, subtree_us, single_us);
+}
+
+/**
+ * @brief Overwritten and deleted settings are loaded with their last value.
+ */
+ZTEST(settings, test_overwrite_and_delete)
+{
+	const uint32_t overwritten = 7U;
+	const uint32_t deleted = 8U;
+
+	const uint32_t value = 42U;
+	zassert_ok(settings_save_one(name{overwritten}, &value, sizeof(value)));
+	zassert_ok(settings_delete(name{deleted}));
+
+	zassert_equal(load_single(overwritten), value);
+	zassert_false(load_single(deleted).has_value());
+	zassert_equal(load_all(), setting_count - 1U);
+
+	const uint32_t original = value_of(overwritten);
+	const uint32_t restored = value_of(deleted);
+	zassert_ok(settings_save_one(name{overwritten}, &original, sizeof(original)));
+	zassert_ok(settings_save_one(name{deleted}, &restored, sizeof(restored)));
+	zassert_equal(load_all(), setting_count);
+}
+
+#ifdef CONFIG_APP_SETTINGS_BACKEND
+/**
+ * @brief Another instance of the backend finds the stored settings, like after a reboot.
+ */
+ZTEST(settings, test_index_built_at_mount)
+{
+	static storage::settings_backend backend{shared_storage()};
+
+	const auto start = k_cycle_get_32();
+	zassert_no_error(backend.init());
+	const uint32_t init_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+	zassert_equal(backend.size(), setting_count);
+
+	const name single{single_setting};
+	std::optional<uint32_t> value;
+	const struct settings_load_arg arg = {
+		.subtree = single,
+		.cb = read_single,
+		.param = &value,
+	};
+	zassert_no_error(backend.load(arg));
+	zassert_equal(value, value_of(single_setting));
+
+	TC_PRINT("%s: index of %u settings built in %u us\n", backend_name, setting_count,
+		 init_us);
+}
+#endif
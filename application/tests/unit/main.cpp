@@ -6,6 +6,72 @@
 
 #include <zephyr/ztest.h>
 #include "os/kernel.hpp"
+#include "util/crc32.hpp"
+#include "util/inplace_function.hpp"
+#include "util/small_map.hpp"
+#include "util/static_vector.hpp"
+#include "util/system_error.hpp"
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <vector>
+
+namespace
+{
+// std::function has no allocator parameter, so the heap allocations can only be counted in
+// operator new; they are counted only while an allocation_counter exists
+bool counting = false;
+size_t allocations = 0U;
+
+/**
+ * @brief Counts the heap allocations during its lifetime, for comparing with the std containers.
+ */
+class allocation_counter
+{
+public:
+	allocation_counter()
+	{
+		allocations = 0U;
+		counting = true;
+	}
+
+	~allocation_counter()
+	{
+		counting = false;
+	}
+
+	allocation_counter(const allocation_counter &) = delete;
+	allocation_counter &operator=(const allocation_counter &) = delete;
+
+	size_t count() const
+	{
+		return allocations;
+	}
+};
+} // namespace
+
+void *operator new(size_t size)
+{
+	if (counting) {
+		++allocations;
+	}
+	if (void *memory = std::malloc(size)) {
+		return memory;
+	}
+	throw std::bad_alloc{};
+}
+
+void operator delete(void *memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+	std::free(memory);
+}
 
 ZTEST_SUITE(os_tests, NULL, NULL, NULL, NULL, NULL);
 
@@ -28,3 +94,277 @@ ZTEST(os_tests, test_result_to_error_code_conversion)
 	zassert_equal(os::result_to_error_code(-EAGAIN),
 		      util::error_code{util::errc::resource_unavailable_try_again});
 }
+
+ZTEST_SUITE(util_tests, NULL, NULL, NULL, NULL, NULL);
+
+/**
+ * @brief Both CRC32 variants give the standard check value and agree for all lengths.
+ */
+ZTEST(util_tests, test_crc32)
+{
+	constexpr std::array<uint8_t, 9> check_input{'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+	zassert_equal(util::crc32::calculate(check_input), 0xCBF43926U);
+	zassert_equal(util::crc32::calculate_slice_by_8(check_input), 0xCBF43926U);
+	zassert_equal(util::crc32::calculate({}), 0U);
+
+	std::array<uint8_t, 100> data{};
+	for (size_t i = 0; i < data.size(); ++i) {
+		data[i] = static_cast<uint8_t>(i * 37U + 5U);
+	}
+
+	// unaligned starts and all tail lengths of slice-by-8
+	for (size_t length = 0; length < data.size(); ++length) {
+		const auto input = std::span<const uint8_t>{data}.subspan(1U, length);
+		zassert_equal(util::crc32::calculate(input),
+			      util::crc32::calculate_slice_by_8(input));
+	}
+
+	// calculation over parts of the data
+	const auto first = std::span<const uint8_t>{data}.first(33U);
+	const auto second = std::span<const uint8_t>{data}.subspan(33U);
+	zassert_equal(util::crc32::update(util::crc32::update(0U, first), second),
+		      util::crc32::calculate(data));
+	zassert_equal(util::crc32::update(0U, check_input), 0xCBF43926U);
+}
+
+namespace
+{
+constexpr std::array<util::error_message, 3> test_messages{{
+	{1, "First error"},
+	{2, "Second error"},
+	{5, "Fifth error"},
+}};
+static_assert(util::is_valid_message_table(test_messages));
+
+constexpr std::array<util::error_message, 2> unsorted_messages{{{2, "Second"}, {1, "First"}}};
+static_assert(!util::is_valid_message_table(unsorted_messages));
+
+constinit const util::error_category test_category{"test", test_messages};
+} // namespace
+
+/**
+ * @brief Messages are looked up in the table of the category, comparisons use the conditions.
+ */
+ZTEST(util_tests, test_error_category_table)
+{
+	zassert_str_equal(test_category.name(), "test");
+	zassert_str_equal(util::error_code(1, test_category).message(), "First error");
+	zassert_str_equal(util::error_code(5, test_category).message(), "Fifth error");
+	zassert_str_equal(util::error_code(3, test_category).message(), "Unknown error");
+	zassert_str_equal(util::error_code(6, test_category).message(), "Unknown error");
+
+	// errors of a category without condition category are their own condition
+	const util::error_code error{2, test_category};
+	zassert_true(error == util::error_condition(2, test_category));
+	zassert_false(error == util::error_condition(2, util::generic_category()));
+
+	// system errors are equivalent to the generic errors with the same value
+	const util::error_code system_error{EIO, util::system_category()};
+	zassert_true(system_error == util::error_condition{util::errc::io_error});
+	zassert_false(system_error == util::error_code{util::errc::io_error});
+	zassert_true(util::error_code{util::errc::io_error} ==
+		     util::error_condition{util::errc::io_error});
+	zassert_not_null(system_error.message());
+}
+
+namespace
+{
+constexpr int sum_of_squares()
+{
+	util::static_vector<int, 4> values{1, 2, 3};
+	values.push_back(4);
+	const bool added = values.push_back(5); // full
+	values.erase(values.begin());
+
+	int sum = added ? 100 : 0;
+	for (const auto value : values) {
+		sum += value * value;
+	}
+	return sum;
+}
+static_assert(sum_of_squares() == 4 + 9 + 16);
+
+constexpr int lookup()
+{
+	util::small_map<uint16_t, int, 4> map;
+	map.insert_or_assign(7U, 70);
+	map.insert_or_assign(3U, 30);
+	map.insert_or_assign(7U, 71);
+	return *map.get(3U) + *map.get(7U) + (map.contains(5U) ? 1000 : 0);
+}
+static_assert(lookup() == 101);
+
+/// Counts its living instances, to check that the containers construct and destroy correctly.
+struct counted {
+	static inline int instances = 0;
+
+	explicit counted(int value) : value(value)
+	{
+		++instances;
+	}
+
+	counted(const counted &other) : value(other.value)
+	{
+		++instances;
+	}
+
+	counted &operator=(const counted &) = default;
+
+	~counted()
+	{
+		--instances;
+	}
+
+	int value;
+};
+} // namespace
+
+/**
+ * @brief Elements are constructed when added, destroyed when removed and the capacity is kept.
+ */
+ZTEST(util_tests, test_static_vector)
+{
+	{
+		util::static_vector<counted, 3> values;
+		zassert_equal(counted::instances, 0);
+
+		zassert_not_null(values.emplace_back(1));
+		zassert_true(values.push_back(counted{3}));
+		zassert_equal(values.insert(values.begin() + 1, counted{2})->value, 2);
+		zassert_true(values.full());
+		zassert_false(values.push_back(counted{4}));
+		zassert_equal(values.insert(values.begin(), counted{0}), values.end());
+		zassert_equal(counted::instances, 3);
+
+		const std::span<const counted> view{values};
+		zassert_equal(view.size(), 3U);
+		zassert_equal(view[0].value, 1);
+		zassert_equal(view[1].value, 2);
+		zassert_equal(view[2].value, 3);
+
+		const auto copy = values;
+		zassert_equal(counted::instances, 6);
+
+		values.erase(values.begin());
+		zassert_equal(values.front().value, 2);
+		zassert_equal(values.back().value, 3);
+		zassert_equal(copy.size(), 3U);
+	}
+	zassert_equal(counted::instances, 0);
+}
+
+ZTEST(util_tests, test_small_map)
+{
+	util::small_map<uint16_t, uint32_t, 8> map;
+
+	for (const uint16_t id : {5U, 1U, 9U, 3U}) {
+		zassert_not_equal(map.insert_or_assign(id, id * 10U), map.end());
+	}
+	zassert_equal(map.size(), 4U);
+
+	// the entries are sorted by their key
+	uint16_t previous = 0U;
+	for (const auto &[id, value] : map) {
+		zassert_true(id > previous);
+		zassert_equal(value, id * 10U);
+		previous = id;
+	}
+
+	zassert_equal(*map.get(9U), 90U);
+	zassert_is_null(map.get(4U));
+	zassert_true(map.erase(1U));
+	zassert_false(map.erase(1U));
+	zassert_equal(map.begin()->first, 3U);
+
+	// a full map keeps assigning existing keys, but does not take new ones
+	for (uint16_t id = 10U; !map.full(); ++id) {
+		map.insert_or_assign(id, 0U);
+	}
+	zassert_equal(map.insert_or_assign(100U, 1U), map.end());
+	zassert_not_equal(map.insert_or_assign(5U, 1U), map.end());
+	zassert_equal(*map.get(5U), 1U);
+}
+
+ZTEST(util_tests, test_inplace_function)
+{
+	int calls = 0;
+	util::inplace_function<int(int)> add_and_count = [&calls](int value) {
+		++calls;
+		return value + 1;
+	};
+	zassert_true(static_cast<bool>(add_and_count));
+	zassert_equal(add_and_count(1), 2);
+
+	auto copy = add_and_count;
+	zassert_equal(copy(2), 3);
+	zassert_equal(calls, 2);
+
+	auto moved = std::move(copy);
+	zassert_false(static_cast<bool>(copy));
+	zassert_equal(moved(3), 4);
+
+	// the stored callable is destroyed with the function
+	{
+		const util::inplace_function<int()> function = [value = counted{7}] {
+			return value.value;
+		};
+		zassert_equal(function(), 7);
+		zassert_equal(counted::instances, 1);
+	}
+	zassert_equal(counted::instances, 0);
+
+	moved = nullptr;
+	zassert_false(static_cast<bool>(moved));
+}
+
+/**
+ * @brief The heap-free containers do not allocate, where the std containers do.
+ */
+ZTEST(util_tests, test_allocations_compared_to_std)
+{
+	constexpr size_t element_count = 16U;
+
+	std::vector<uint32_t> std_vector;
+	size_t vector_allocations = 0U;
+	{
+		const allocation_counter counter;
+		for (uint32_t i = 0; i < element_count; ++i) {
+			std_vector.push_back(i);
+		}
+		vector_allocations = counter.count();
+	}
+
+	util::static_vector<uint32_t, element_count> static_vector;
+	{
+		const allocation_counter counter;
+		for (uint32_t i = 0; i < element_count; ++i) {
+			static_vector.push_back(i);
+		}
+		zassert_equal(counter.count(), 0U);
+	}
+
+	// a callback with a context that exceeds the small buffer of std::function
+	const std::array<void *, 3> context{};
+	size_t function_allocations = 0U;
+	{
+		const allocation_counter counter;
+		const std::function<size_t()> std_function = [context] { return context.size(); };
+		function_allocations = counter.count();
+		zassert_equal(std_function(), context.size());
+	}
+
+	{
+		const allocation_counter counter;
+		const util::inplace_function<size_t(), sizeof(context)> inplace_function =
+			[context] { return context.size(); };
+		zassert_equal(counter.count(), 0U);
+		zassert_equal(inplace_function(), context.size());
+	}
+
+	TC_PRINT("allocations for %zu elements: std::vector %zu, util::static_vector 0\n",
+		 element_count, vector_allocations);
+	TC_PRINT("allocations for a callback of %zu bytes: std::function %zu, "
+		 "util::inplace_function 0\n",
+		 sizeof(context), function_allocations);
+	zassert_true(vector_allocations > 0U);
+}